@@ -3,12 +3,17 @@
 
 #include <QPushButton>
 #include <QPropertyAnimation>
+#include <QVariantAnimation>
 #include <QEasingCurve>
 #include <QGraphicsDropShadowEffect>
 #include <QEvent>
 #include <QPainter>
 #include <QPixmap>
+#include <QImage>
 #include <QMouseEvent>
+#include <QPixmapCache>
+#include <QCache>
+#include <QAbstractAnimation>
 
 class AnimatedPushButton : public QPushButton
 {
@@ -41,6 +46,41 @@ public:
         shadowEffect->setOffset(0, 0);  // 设置光环偏移量
         shadowEffect->setEnabled(false); // 初始时不显示光环
         setGraphicsEffect(shadowEffect); // 将效果应用到按钮
+
+        // 每种状态预先创建一个动画，之后只重新设置参数并重新启动，不再每次新建
+        hoverAnimation = new QPropertyAnimation(this, "geometry", this);
+        connect(hoverAnimation, &QPropertyAnimation::finished, this, QOverload<>::of(&QWidget::update));
+
+        resetAnimation = new QPropertyAnimation(this, "geometry", this);
+        connect(resetAnimation, &QPropertyAnimation::finished, this, QOverload<>::of(&QWidget::update));
+
+        scaleAnimation = new QVariantAnimation(this);
+        connect(scaleAnimation, &QVariantAnimation::valueChanged, this, [this](const QVariant &value) {
+            currentScale = value.toReal();
+            update();
+        });
+
+        resetShadowAnimation = new QPropertyAnimation(shadowEffect, "blurRadius", this);
+        resetShadowAnimation->setStartValue(30);
+        resetShadowAnimation->setEndValue(15);
+        // 在动画结束时关闭光环效果
+        connect(resetShadowAnimation, &QPropertyAnimation::finished, this, [this]() {
+            shadowEffect->setEnabled(false);
+            isResetting = false;  // 恢复动画结束，标记恢复状态结束
+        });
+
+        clickAnimation = new QPropertyAnimation(shadowEffect, "blurRadius", this);
+        clickAnimation->setStartValue(15);  // 初始光环模糊半径
+        clickAnimation->setEndValue(40);   // 扩展光环的模糊半径
+
+        releaseAnimation = new QPropertyAnimation(shadowEffect, "blurRadius", this);
+        releaseAnimation->setStartValue(40);  // 当前光环模糊半径
+        releaseAnimation->setEndValue(15);   // 恢复光环模糊半径
+        releaseAnimation->setEasingCurve(QEasingCurve::OutQuad);
+        // 动画完成后关闭光环
+        connect(releaseAnimation, &QPropertyAnimation::finished, this, [this]() {
+            shadowEffect->setEnabled(false);
+        });
     }
 
     /**
@@ -86,6 +126,32 @@ public:
         resetEasingCurve = easingCurve;
     }
 
+    /**
+     * @brief 设置是否以绘制时的变换实现悬停缩放
+     *
+     * 启用后悬停与恢复动画不再改变按钮的 geometry，不会逐帧触发父布局重新布局，
+     * 而是在绘制时缩放背景：静止时按 1/悬停缩放比例绘制在按钮中央，悬停时放大到整个按钮区域，
+     * 因此应把按钮大小设置为悬停后的大小。默认关闭。
+     *
+     * @param enabled 是否启用
+     */
+    void setTransformScaling(bool enabled)
+    {
+        if (transformScaling == enabled)
+            return;
+
+        // 离开 geometry 模式时若动画进行到一半，先把按钮恢复到原始几何，避免停留在中间大小
+        if (enabled && isAnimating()) {
+            setGeometry(initialGeometry);
+        }
+        hoverAnimation->stop();
+        resetAnimation->stop();
+        scaleAnimation->stop();
+        transformScaling = enabled;
+        currentScale = 1.0;
+        update();
+    }
+
     /**
      * @brief 设置按钮的背景图片
      *
@@ -93,13 +159,14 @@ public:
      */
     void setButtonImage(const QString &imagePath)
     {
-        QPixmap pixmap(imagePath); // 加载图片
-        if (pixmap.isNull()) {
+        QImage image = sourceImage(imagePath); // 加载图片（同一路径只解码一次）
+        if (image.isNull()) {
             qDebug() << "Failed to load image at" << imagePath;
             return; // 如果加载失败，直接返回
         }
 
         currentBackgroundImagePath = imagePath; // 保存当前图像路径
+        scaledBackground = QPixmap();           // 使已缩放的背景失效
         update(); // 触发重新绘制
     }
 
@@ -113,7 +180,7 @@ protected:
     {
         QPushButton::enterEvent(event);
         // 只有在没有动画时才获取按钮的原始几何信息
-        if (!isResetting) {
+        if (!isResetting && !transformScaling) {
             initialGeometry = geometry();
         }
 
@@ -171,20 +238,103 @@ protected:
     {
         QPainter painter(this);
         painter.setRenderHint(QPainter::Antialiasing);
-        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+        // 变换缩放模式：以按钮中心为原点缩放，静止时为 1/hoverScaleFactor，悬停时为 1
+        if (transformScaling && hoverScaleFactor > 0) {
+            qreal scale = currentScale / hoverScaleFactor;
+            if (!qFuzzyCompare(scale, 1.0)) {
+                QPointF center = QRectF(rect()).center();
+                painter.translate(center);
+                painter.scale(scale, scale);
+                painter.translate(-center);
+                painter.setRenderHint(QPainter::SmoothPixmapTransform);
+            }
+        }
 
         // 如果当前按钮背景图路径不为空，绘制背景图
         if (!currentBackgroundImagePath.isEmpty()) {
-            QPixmap pixmap(currentBackgroundImagePath);
+            const QPixmap &pixmap = backgroundForSize(size());
             if (!pixmap.isNull()) {
-                // 将图像绘制为按钮大小的背景图，保持图像比例
-                QRect rect = this->rect(); // 获取按钮区域
-                painter.drawPixmap(rect, pixmap);  // 将图像绘制为按钮大小的背景
+                // 背景已按按钮大小与设备像素比缩放，直接贴图
+                painter.drawPixmap(QPointF(0, 0), pixmap);
             }
         }
     }
 
 private:
+    /**
+     * @brief 获取解码后的背景原图，同一路径只从磁盘解码一次，所有按钮共享（界面线程）
+     *
+     * 原图以 QImage 保存，按解码后的大小计入上限，超出时淘汰最久未使用的；
+     * QImage 不依赖 QGuiApplication，程序退出时析构静态缓存也是安全的。
+     *
+     * @param path 图片路径
+     * @return 原图，加载失败时为空（不缓存，下次重新尝试）
+     */
+    static QImage sourceImage(const QString &path)
+    {
+        static QCache<QString, QImage> sources(sourceCacheLimitKB);
+        if (const QImage *cached = sources.object(path))
+            return *cached;
+
+        QImage image(path);
+        if (!image.isNull()) {
+            sources.insert(path, new QImage(image), qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+        }
+        return image;
+    }
+
+    /**
+     * @brief 动画是否正在进行
+     */
+    bool isAnimating() const
+    {
+        return (hoverAnimation && hoverAnimation->state() == QAbstractAnimation::Running)
+            || (resetAnimation && resetAnimation->state() == QAbstractAnimation::Running);
+    }
+
+    /**
+     * @brief 获取按指定大小与当前设备像素比缩放好的背景
+     *
+     * 尺寸不变时直接返回上次的结果；平滑缩放结果按路径、尺寸与设备像素比存入 QPixmapCache，
+     * 同样大小的按钮共享。动画期间尺寸逐帧变化，只做快速缩放且不放入共享缓存，动画结束后重新平滑缩放。
+     *
+     * @param logicalSize 按钮大小（逻辑像素）
+     * @return 缩放后的背景，原图加载失败时为空
+     */
+    const QPixmap &backgroundForSize(const QSize &logicalSize)
+    {
+        qreal ratio = devicePixelRatioF();
+        bool smooth = !isAnimating();
+        if (!scaledBackground.isNull() && scaledBackgroundSize == logicalSize && scaledBackgroundRatio == ratio
+            && (scaledBackgroundSmooth || !smooth)) {
+            return scaledBackground;
+        }
+
+        QSize deviceSize = logicalSize * ratio;
+        QString key = QString("AnimatedPushButton:%1:%2x%3@%4")
+            .arg(currentBackgroundImagePath).arg(deviceSize.width()).arg(deviceSize.height()).arg(ratio);
+        if (!QPixmapCache::find(key, &scaledBackground)) {
+            QImage source = sourceImage(currentBackgroundImagePath);
+            if (source.isNull() || deviceSize.isEmpty()) {
+                scaledBackground = QPixmap();
+                return scaledBackground;
+            }
+            scaledBackground = QPixmap::fromImage(source.scaled(deviceSize, Qt::IgnoreAspectRatio,
+                                                                smooth ? Qt::SmoothTransformation : Qt::FastTransformation));
+            scaledBackground.setDevicePixelRatio(ratio);
+            if (smooth) {
+                QPixmapCache::insert(key, scaledBackground);
+            }
+        } else {
+            smooth = true;
+        }
+        scaledBackgroundSize = logicalSize;
+        scaledBackgroundRatio = ratio;
+        scaledBackgroundSmooth = smooth;
+        return scaledBackground;
+    }
+
     /**
      * @brief 启动鼠标悬停时的动画
      *
@@ -196,6 +346,11 @@ private:
             return;  // 当前有动画在进行时，不启动新的动画
         }
 
+        if (transformScaling) {
+            restartScaleAnimation(hoverScaleFactor, hoverDuration, hoverEasingCurve);
+            return;
+        }
+
         // 记录按钮的初始位置和大小
         QRect startRect = initialGeometry;
         QRect endRect = startRect.adjusted(
@@ -205,7 +360,7 @@ private:
             startRect.height() * (hoverScaleFactor - 1) / 2
             );
 
-        hoverAnimation = new QPropertyAnimation(this, "geometry");
+        hoverAnimation->stop();
         hoverAnimation->setDuration(hoverDuration);
         hoverAnimation->setStartValue(startRect);
         hoverAnimation->setEndValue(endRect);
@@ -226,27 +381,40 @@ private:
 
         isResetting = true;  // 设置恢复动画状态
 
-        hoverAnimation->stop();
-        // 恢复到初始状态
-        resetAnimation = new QPropertyAnimation(this, "geometry");
-        resetAnimation->setDuration(resetDuration);
-        resetAnimation->setStartValue(geometry());
-        resetAnimation->setEndValue(initialGeometry);  // 使用初始的几何值
-        resetAnimation->setEasingCurve(resetEasingCurve);
-        resetAnimation->start();
+        if (transformScaling) {
+            restartScaleAnimation(1.0, resetDuration, resetEasingCurve);
+        } else {
+            hoverAnimation->stop();
+            // 恢复到初始状态
+            resetAnimation->stop();
+            resetAnimation->setDuration(resetDuration);
+            resetAnimation->setStartValue(geometry());
+            resetAnimation->setEndValue(initialGeometry);  // 使用初始的几何值
+            resetAnimation->setEasingCurve(resetEasingCurve);
+            resetAnimation->start();
+        }
 
         // 恢复光环效果
-        QPropertyAnimation *resetShadowEffect = new QPropertyAnimation(shadowEffect, "blurRadius");
-        resetShadowEffect->setDuration(resetDuration);
-        resetShadowEffect->setStartValue(30);
-        resetShadowEffect->setEndValue(15);
-        resetShadowEffect->start();
+        resetShadowAnimation->stop();
+        resetShadowAnimation->setDuration(resetDuration);
+        resetShadowAnimation->start();
+    }
 
-        // 在动画结束时关闭光环效果
-        connect(resetShadowEffect, &QPropertyAnimation::finished, this, [this]() {
-            shadowEffect->setEnabled(false);
-            isResetting = false;  // 恢复动画结束，标记恢复状态结束
-        });
+    /**
+     * @brief 从当前缩放比例开始重新启动缩放动画（变换缩放模式）
+     *
+     * @param target 目标缩放比例
+     * @param duration 动画持续时间
+     * @param easingCurve 缓动曲线
+     */
+    void restartScaleAnimation(qreal target, int duration, const QEasingCurve &easingCurve)
+    {
+        scaleAnimation->stop();
+        scaleAnimation->setDuration(duration);
+        scaleAnimation->setStartValue(currentScale);
+        scaleAnimation->setEndValue(target);
+        scaleAnimation->setEasingCurve(easingCurve);
+        scaleAnimation->start();
     }
 
     /**
@@ -260,10 +428,9 @@ private:
         shadowEffect->setEnabled(true);  // 激活光环
 
         // 通过动画控制光环的大小
-        clickAnimation = new QPropertyAnimation(shadowEffect, "blurRadius");
+        releaseAnimation->stop();
+        clickAnimation->stop();
         clickAnimation->setDuration(clickDuration);
-        clickAnimation->setStartValue(15);  // 初始光环模糊半径
-        clickAnimation->setEndValue(40);   // 扩展光环的模糊半径
         clickAnimation->setEasingCurve(clickEasingCurve);
         clickAnimation->start();
     }
@@ -276,20 +443,15 @@ private:
     void startReleaseAnimation()
     {
         // 通过动画控制光环的大小移除
-        QPropertyAnimation *releaseAnimation = new QPropertyAnimation(shadowEffect, "blurRadius");
+        clickAnimation->stop();
+        releaseAnimation->stop();
         releaseAnimation->setDuration(clickDuration);
-        releaseAnimation->setStartValue(40);  // 当前光环模糊半径
-        releaseAnimation->setEndValue(15);   // 恢复光环模糊半径
-        releaseAnimation->setEasingCurve(QEasingCurve::OutQuad);
         releaseAnimation->start();
-
-        // 动画完成后关闭光环
-        connect(releaseAnimation, &QPropertyAnimation::finished, this, [this]() {
-            shadowEffect->setEnabled(false);
-        });
     }
 
 private:
+    static constexpr qsizetype sourceCacheLimitKB = 32 * 1024;  ///< 共享原图缓存的上限（KB）
+
     bool hoverEnabled;               ///< 是否启用悬停动画
     bool clickEnabled;               ///< 是否启用点击动画
     bool resetEnabled;               ///< 是否启用恢复动画
@@ -308,10 +470,20 @@ private:
 
     QRect initialGeometry;           ///< 按钮的初始几何信息（用于恢复动画）
     QString currentBackgroundImagePath;  ///< 当前按钮的背景图片路径
+    QPixmap scaledBackground;            ///< 按当前大小缩放好的背景
+    QSize scaledBackgroundSize;          ///< scaledBackground 对应的按钮大小（逻辑像素）
+    qreal scaledBackgroundRatio = 0;     ///< scaledBackground 对应的设备像素比
+    bool scaledBackgroundSmooth = false; ///< scaledBackground 是否为平滑缩放
     QGraphicsDropShadowEffect *shadowEffect;  ///< 光环效果
     QPropertyAnimation *hoverAnimation = nullptr;  ///< 悬停动画
     QPropertyAnimation *clickAnimation = nullptr;  ///< 点击动画
     QPropertyAnimation *resetAnimation = nullptr;  ///< 恢复动画
+    QPropertyAnimation *resetShadowAnimation = nullptr;  ///< 恢复时的光环动画
+    QPropertyAnimation *releaseAnimation = nullptr;      ///< 释放时的光环动画
+    QVariantAnimation *scaleAnimation = nullptr;         ///< 变换缩放模式的悬停与恢复动画
+
+    bool transformScaling = false;   ///< 是否以绘制时的变换实现悬停缩放
+    qreal currentScale = 1.0;        ///< 变换缩放模式的当前缩放比例（1 为静止，hoverScaleFactor 为悬停）
 };
 
 #endif // ANIMATEDPUSHBUTTON_H
@@ -0,0 +1,277 @@
+#ifndef CONVERTERLOGBRIDGE_H
+#define CONVERTERLOGBRIDGE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QLabel>
+#include <QPointer>
+#include <QThread>
+#include <QEvent>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "EncodingConverter.h"
+#include "DragArea.h"
+
+/**
+ * @brief ConverterLogBridge 类
+ *
+ * 把 EncodingConverter 的日志线程安全地交给 DragArea 显示。
+ * 工作线程调用 write() 时只把日志放入无锁队列（EncodingConverter::LogQueue）后立即返回，
+ * 界面线程的定时器每帧取出一批日志，一次性追加到 DragArea 的日志视图；队列已空且进度不再变化时定时器停止，
+ * 下一次 write() 或 wake() 时重新启动。
+ * 指定转换器后，还会在 DragArea 右下角显示进度浮层（已处理文件数、数据量与 MB/s），
+ * 此时可通过 EncodingConverter::setLogLevel() 屏蔽逐文件的 INFO 日志，只保留进度与警告。
+ *
+ * 需在界面线程中通过 create() 创建，再传给 EncodingConverter::setLogSink()：
+ * @code
+ * auto bridge = ConverterLogBridge::create(dragArea, &converter);
+ * converter.setLogSink(bridge);
+ * bridge->wake();  // 屏蔽了 INFO 日志时，开始转换后唤醒一次以刷新进度
+ * @endcode
+ */
+class ConverterLogBridge : public QObject, public EncodingConverter::LogSink
+{
+public:
+    using OverflowPolicy = EncodingConverter::AsyncLogSink::OverflowPolicy;
+
+    /**
+     * @brief 在界面线程中创建日志桥
+     *
+     * 转换器持有的最后一个引用可能在工作线程中释放，因此返回的 std::shared_ptr 不直接 delete，
+     * 而是调用 deleteLater() 交给界面线程的事件循环删除。
+     * @param area 显示日志的 DragArea（需处于 LogOutputMode）
+     * @param converter 用于显示进度的转换器，为空时不显示进度浮层
+     * @param capacity 队列容量，向上取整为 2 的幂
+     * @param policy 队列已满时的处理方式
+     * @return 日志桥
+     */
+    static inline std::shared_ptr<ConverterLogBridge> create(DragArea *area, const EncodingConverter *converter = nullptr,
+                                                             size_t capacity = 65536, OverflowPolicy policy = OverflowPolicy::Block)
+    {
+        return std::shared_ptr<ConverterLogBridge>(new ConverterLogBridge(area, converter, capacity, policy),
+                                                   [](ConverterLogBridge *bridge) { bridge->deleteLater(); });
+    }
+
+    ConverterLogBridge(const ConverterLogBridge&) = delete;
+    ConverterLogBridge& operator=(const ConverterLogBridge&) = delete;
+
+    /**
+     * @brief 放入一条日志，可在任意线程调用
+     *
+     * 队列已满时按 OverflowPolicy 等待或丢弃；在界面线程中调用时先就地取出一批，避免自身阻塞。
+     */
+    void write(EncodingConverter::LogLevel level, const std::string& message) override
+    {
+        while (!queue.tryPush(level, message)) {
+            if (QThread::currentThread() == thread()) {
+                drain();
+                continue;
+            }
+            if (policy == OverflowPolicy::Drop) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            std::this_thread::yield();
+        }
+        wake();
+    }
+
+    /**
+     * @brief 启动已停止的取出定时器，可在任意线程调用
+     *
+     * write() 会自动调用；通过 setLogLevel() 屏蔽了逐文件日志时，可在开始转换后
+     * （或在 onFileDone 回调中）调用，使进度浮层在没有日志时也能刷新。
+     */
+    inline void wake()
+    {
+        if (drainActive.exchange(true, std::memory_order_acq_rel))
+            return;
+        if (QThread::currentThread() == thread()) {
+            drainTimer->start();
+        } else {
+            QMetaObject::invokeMethod(this, [this]() { drainTimer->start(); }, Qt::QueuedConnection);
+        }
+    }
+
+    /**
+     * @brief 设置是否显示进度浮层
+     * @param visible 是否显示
+     */
+    inline void setProgressVisible(bool visible)
+    {
+        progressVisible = visible;
+        if (overlay && !visible) {
+            overlay->hide();
+        }
+        if (visible) {
+            wake();
+        }
+    }
+
+    /**
+     * @brief 因队列已满被丢弃的日志条数
+     */
+    inline size_t droppedCount() const
+    {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+protected:
+    /**
+     * @brief 事件过滤器，DragArea 尺寸变化时重新放置进度浮层
+     */
+    bool eventFilter(QObject *obj, QEvent *event) override
+    {
+        if (obj == area && event->type() == QEvent::Resize) {
+            placeOverlay();
+        }
+        return QObject::eventFilter(obj, event);
+    }
+
+private:
+    /**
+     * @brief 构造函数，取出定时器在第一次 write() 或 wake() 时启动
+     */
+    ConverterLogBridge(DragArea *area, const EncodingConverter *converter, size_t capacity, OverflowPolicy policy)
+        : QObject(nullptr),
+        area(area),
+        converter(converter),
+        queue(capacity),
+        policy(policy),
+        drainTimer(new QTimer(this)),
+        progressVisible(true),
+        ticksSinceProgress(0)
+    {
+        if (area && converter) {
+            overlay = new QLabel(area);
+            overlay->setStyleSheet("background: rgba(0, 0, 0, 160); color: white; padding: 4px 8px; border-radius: 4px;");
+            overlay->setAttribute(Qt::WA_TransparentForMouseEvents);
+            overlay->hide();
+            area->installEventFilter(this);
+        }
+
+        drainTimer->setInterval(16);
+        connect(drainTimer, &QTimer::timeout, this, &ConverterLogBridge::drain);
+    }
+
+    ~ConverterLogBridge() override
+    {
+        drainTimer->stop();
+        delete overlay.data();
+    }
+
+    static constexpr int maxBatch = 4096;            ///< 每帧最多取出的日志条数
+    static constexpr int ticksPerProgress = 15;      ///< 每隔多少帧刷新一次进度（约 250 毫秒）
+
+    /**
+     * @brief 取出一批日志交给 DragArea，并定期刷新进度（界面线程）
+     *
+     * 本帧没有日志、且没有转换器或进度已不再变化时停止定时器。
+     */
+    inline void drain()
+    {
+        QStringList batch;
+        bool more = popBatch(batch);
+
+        bool progressTick = ++ticksSinceProgress >= ticksPerProgress;
+        bool running = false;
+        if (progressTick) {
+            ticksSinceProgress = 0;
+            running = updateProgress();
+        }
+
+        if (!more && batch.isEmpty() && (!converter || (progressTick && !running))) {
+            drainTimer->stop();
+            drainActive.exchange(false, std::memory_order_acq_rel);
+            // 标记停止后再取一次：工作线程可能在此之前放入了日志，却因看到定时器仍在运行而没有唤醒
+            popBatch(batch);
+            if (!batch.isEmpty()) {
+                wake();
+            }
+        }
+
+        if (area && !batch.isEmpty()) {
+            area->appendLogs(batch);
+        }
+    }
+
+    /**
+     * @brief 从队列取出日志追加到 batch，最多取到 maxBatch 条
+     * @return batch 已满（队列中可能还有日志）时为 true
+     */
+    inline bool popBatch(QStringList &batch)
+    {
+        EncodingConverter::LogLevel level;
+        std::string message;
+        while (batch.size() < maxBatch) {
+            if (!queue.tryPop(level, message))
+                return false;
+            batch.append(QString::fromUtf8(EncodingConverter::levelPrefix(level)) + QString::fromStdString(message));
+        }
+        return true;
+    }
+
+    /**
+     * @brief 根据转换器的统计刷新进度浮层
+     * @return 转换是否仍在进行（距上次刷新耗时有变化）
+     */
+    inline bool updateProgress()
+    {
+        if (!overlay || !converter || !progressVisible)
+            return false;
+
+        EncodingConverter::ConversionReport report = converter->statistics();
+        bool running = report.elapsedSeconds != lastElapsedSeconds;
+        lastElapsedSeconds = report.elapsedSeconds;
+        if (report.fileCount == 0 && report.elapsedSeconds == 0) {
+            overlay->hide();
+            return running;
+        }
+
+        QString text = QString("已处理 %1 个文件  %2 MB  %3 MB/s")
+            .arg(static_cast<qulonglong>(report.fileCount))
+            .arg(static_cast<double>(report.totalBytes) / (1024.0 * 1024.0), 0, 'f', 1)
+            .arg(report.throughputMBps(), 0, 'f', 1);
+        size_t lost = droppedCount();
+        if (lost > 0) {
+            text += QString("  丢弃 %1 条日志").arg(static_cast<qulonglong>(lost));
+        }
+        if (overlay->text() != text) {
+            overlay->setText(text);
+            overlay->adjustSize();
+            placeOverlay();
+        }
+        overlay->show();
+        overlay->raise();
+        return running;
+    }
+
+    /**
+     * @brief 把进度浮层放在 DragArea 右下角
+     */
+    inline void placeOverlay()
+    {
+        if (!overlay || !area)
+            return;
+        overlay->move(area->width() - overlay->width() - 8, area->height() - overlay->height() - 8);
+    }
+
+private:
+    QPointer<DragArea> area;                     ///< 显示日志的控件
+    const EncodingConverter *converter;          ///< 用于显示进度的转换器
+    EncodingConverter::LogQueue queue;           ///< 日志队列
+    OverflowPolicy policy;                       ///< 队列已满时的处理方式
+    std::atomic<size_t> dropped{ 0 };            ///< 丢弃的日志条数
+
+    QTimer *drainTimer;                          ///< 取出定时器
+    std::atomic<bool> drainActive{ false };      ///< 取出定时器是否在运行（或已请求启动）
+    QPointer<QLabel> overlay;                    ///< 进度浮层
+    bool progressVisible;                        ///< 是否显示进度浮层
+    int ticksSinceProgress;                      ///< 距上次刷新进度的帧数
+    double lastElapsedSeconds = 0;               ///< 上次刷新时转换的耗时，用于判断转换是否仍在进行
+};
+
+#endif // CONVERTERLOGBRIDGE_H
@@ -17,6 +17,18 @@
 #include <QDebug>
 #include <QFontMetrics>
 #include <QScrollBar>
+#include <QListView>
+#include <QAbstractListModel>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QAtomicInt>
+#include <QPixmapCache>
+#include <QImage>
+#include <QCache>
+#include <QPointer>
+#include <QThreadPool>
+#include <QCoreApplication>
+#include <vector>
 
 /**
  * @brief The DragArea class
@@ -27,6 +39,12 @@
  * - LogOutputMode：显示日志信息，并在追加日志时自动滚动到底部。
  *
  * 用户可通过 setDisplayMode() 在两种模式之间切换。
+ *
+ * 日志模式使用容量固定的环形缓冲区保存日志行，通过 QListView 只布局可见的行；
+ * appendLog() 可在任意线程调用，追加的日志先合并到待显示队列，每帧（约 16 毫秒）最多刷新一次界面。
+ *
+ * 图标只从磁盘解码一次，各尺寸与设备像素比的缩放结果缓存在 QPixmapCache 中；
+ * 缺少缓存时先显示快速缩放的预览，再由线程池从原图平滑缩放，窗口连续缩放时等停止后才平滑缩放。
  */
 class DragArea : public QWidget
 {
@@ -50,13 +68,20 @@ public:
         iconLabel(new QLabel(this)),
         textLabel(new QLabel(this)),
         scrollArea(new QScrollArea(this)),
+        logView(new QListView(this)),
+        logModel(new LogModel(this)),
+        logFlushTimer(new QTimer(this)),
+        iconScaleTimer(new QTimer(this)),
         promptText("点击或将文件/文件夹拖拽至此"),
         filePath("./icons/file.png"),
         folderPath("./icons/folder.png"),
         customWindowTitle("拖放文件示例"),
         showingPrompt(true),
         singleFileMode(false),
-        currentMode(FileSelectionMode)
+        currentMode(FileSelectionMode),
+        currentIconSize(0),
+        iconRequest(0),
+        interactiveResize(false)
     {
         setAcceptDrops(true);
 
@@ -81,9 +106,26 @@ public:
         scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
         scrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
 
+        logView->setModel(logModel);
+        logView->setUniformItemSizes(true);                 // 所有行等高，只布局可见的行
+        logView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+        logView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        logView->setFrameShape(QFrame::NoFrame);
+        logView->setStyleSheet("color: #333; background: transparent;");
+        logView->hide();
+
+        logFlushTimer->setSingleShot(true);
+        logFlushTimer->setInterval(16);
+        connect(logFlushTimer, &QTimer::timeout, this, &DragArea::flushPendingLogs);
+
+        iconScaleTimer->setSingleShot(true);
+        iconScaleTimer->setInterval(120);
+        connect(iconScaleTimer, &QTimer::timeout, this, &DragArea::requestSmoothIcon);
+
         QVBoxLayout *layout = new QVBoxLayout(this);
         layout->addWidget(iconLabel, 0, Qt::AlignCenter);
         layout->addWidget(scrollArea, 1);
+        layout->addWidget(logView, 1);
 
         setLayout(layout);
         setWindowTitle(customWindowTitle);
@@ -101,6 +143,8 @@ public:
     {
         currentMode = mode;
         if (mode == FileSelectionMode) {
+            logView->hide();
+            scrollArea->show();
             textLabel->setAlignment(Qt::AlignCenter);
             showPrompt();
             showingPrompt = true;
@@ -110,7 +154,9 @@ public:
             textLabel->setAlignment(Qt::AlignLeft);
             iconLabel->hide();
             textLabel->clear();
-            scrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+            scrollArea->hide();
+            clearLogs();
+            logView->show();
             showingPrompt = false;
             singleFileMode = false;
         }
@@ -177,31 +223,63 @@ public:
             showingPrompt = true;
             singleFileMode = false;
         } else if (currentMode == LogOutputMode) {
-            textLabel->clear();
+            clearLogs();
         }
         updateStyles();
     }
 
     /**
-     * @brief 在日志模式下追加日志
+     * @brief 在日志模式下追加日志，可在任意线程调用
+     *
+     * 日志先进入待显示队列，由界面线程每帧最多刷新一次；刷新时不处于日志模式则丢弃。
+     * 视图位于底部时自动滚动到最新的日志，用户向上滚动查看时保持位置不变。
      * @param log 要追加的日志信息
      */
     inline void appendLog(const QString &log)
     {
-        if (currentMode != LogOutputMode)
-            return;
+        {
+            QMutexLocker locker(&pendingLogMutex);
+            pendingLogs.append(log);
+        }
+        if (logFlushScheduled.testAndSetOrdered(0, 1)) {
+            // 定时器只能在所属线程启动，通过队列调用转到界面线程
+            QMetaObject::invokeMethod(logFlushTimer, "start", Qt::QueuedConnection);
+        }
+    }
 
-        QString currentText = textLabel->text();
-        if (!currentText.isEmpty()) {
-            currentText += "\n";
+    /**
+     * @brief 在日志模式下追加一批日志，可在任意线程调用，行为与 appendLog() 相同
+     * @param logs 要追加的日志信息
+     */
+    inline void appendLogs(const QStringList &logs)
+    {
+        if (logs.isEmpty())
+            return;
+        {
+            QMutexLocker locker(&pendingLogMutex);
+            pendingLogs.append(logs);
+        }
+        if (logFlushScheduled.testAndSetOrdered(0, 1)) {
+            QMetaObject::invokeMethod(logFlushTimer, "start", Qt::QueuedConnection);
         }
-        currentText += log;
-        textLabel->setText(currentText);
+    }
 
-        QTimer::singleShot(0, this, [=]() {
-            QScrollBar *vScroll = scrollArea->verticalScrollBar();
-            vScroll->setValue(vScroll->maximum());
-        });
+    /**
+     * @brief 设置日志模式最多保留的行数，超出时丢弃最早的日志
+     * @param lines 最大行数，默认为 10000
+     */
+    inline void setMaxLogLines(int lines)
+    {
+        logModel->setCapacity(lines);
+    }
+
+    /**
+     * @brief 获取当前保留的日志行数
+     * @return 日志行数
+     */
+    inline int logLineCount() const
+    {
+        return logModel->rowCount();
     }
 
 protected:
@@ -281,7 +359,9 @@ protected:
     void resizeEvent(QResizeEvent *event) override
     {
         QWidget::resizeEvent(event);
+        interactiveResize = true;
         updateStyles();
+        interactiveResize = false;
     }
 
     /**
@@ -310,9 +390,118 @@ protected:
     }
 
 private:
+    /**
+     * @brief 日志行的环形缓冲区模型
+     *
+     * 达到容量后追加新行时从头部移除最早的行，追加与移除均为 O(批量大小)。
+     */
+    class LogModel : public QAbstractListModel
+    {
+    public:
+        explicit LogModel(QObject *parent = nullptr)
+            : QAbstractListModel(parent), head(0), count(0), capacity(10000)
+        {
+        }
+
+        int rowCount(const QModelIndex &parent = QModelIndex()) const override
+        {
+            return parent.isValid() ? 0 : count;
+        }
+
+        QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+        {
+            if (!index.isValid() || index.row() >= count || role != Qt::DisplayRole)
+                return QVariant();
+            return lines[(head + index.row()) % capacity];
+        }
+
+        /**
+         * @brief 追加一批日志行
+         * @param batch 日志行
+         */
+        inline void appendLines(const QStringList &batch)
+        {
+            int n = batch.size();
+            int skip = 0;
+            if (n > capacity) {
+                skip = n - capacity;
+                n = capacity;
+            }
+            if (n == 0)
+                return;
+            if (static_cast<int>(lines.size()) != capacity)
+                lines.resize(capacity);
+
+            int overflow = count + n - capacity;
+            if (overflow > 0) {
+                beginRemoveRows(QModelIndex(), 0, overflow - 1);
+                for (int i = 0; i < overflow; ++i) {
+                    lines[(head + i) % capacity].clear();
+                }
+                head = (head + overflow) % capacity;
+                count -= overflow;
+                endRemoveRows();
+            }
+
+            beginInsertRows(QModelIndex(), count, count + n - 1);
+            for (int i = 0; i < n; ++i) {
+                lines[(head + count + i) % capacity] = batch[skip + i];
+            }
+            count += n;
+            endInsertRows();
+        }
+
+        /**
+         * @brief 设置容量，保留最新的日志行
+         * @param lineCount 最大行数
+         */
+        inline void setCapacity(int lineCount)
+        {
+            lineCount = qMax(1, lineCount);
+            beginResetModel();
+            std::vector<QString> kept;
+            int keep = qMin(count, lineCount);
+            kept.reserve(keep);
+            for (int i = count - keep; i < count; ++i) {
+                kept.push_back(lines[(head + i) % capacity]);
+            }
+            lines = std::move(kept);
+            capacity = lineCount;
+            head = 0;
+            count = keep;
+            endResetModel();
+        }
+
+        /**
+         * @brief 清空所有日志行
+         */
+        inline void clear()
+        {
+            beginResetModel();
+            lines.clear();
+            head = 0;
+            count = 0;
+            endResetModel();
+        }
+
+    private:
+        std::vector<QString> lines; ///< 环形缓冲区
+        int head;                   ///< 最早一行的位置
+        int count;                  ///< 当前行数
+        int capacity;               ///< 最大行数
+    };
+
     QLabel *iconLabel;     ///< 图标标签
     QLabel *textLabel;     ///< 文本显示标签
     QScrollArea *scrollArea;///< 滚动区域
+    QListView *logView;    ///< 日志视图
+    LogModel *logModel;    ///< 日志模型
+    QTimer *logFlushTimer; ///< 日志刷新定时器
+    QTimer *iconScaleTimer;///< 缩放停止后触发平滑缩放的定时器
+
+    QMutex pendingLogMutex;     ///< 保护待显示日志
+    QStringList pendingLogs;    ///< 待显示日志
+    QAtomicInt logFlushScheduled; ///< 是否已安排刷新
 
     QString promptText;    ///< 提示文本
     QString filePath;      ///< 文件图标路径
@@ -325,6 +514,47 @@ private:
     bool singleFileMode;   ///< 是否为单文件模式
     DisplayMode currentMode;///< 当前显示模式
 
+    QString currentIconPath;   ///< 当前显示的图标路径，为空表示不显示图标
+    QString currentIconKey;    ///< 当前图标的缓存键（路径、尺寸与设备像素比）
+    int currentIconSize;       ///< 当前图标尺寸（设备像素）
+    static constexpr qsizetype sourceIconLimitKB = 16 * 1024; ///< 共享图标原图缓存的上限（KB）
+    quint64 iconRequest;       ///< 图标请求序号，用于丢弃过期的平滑缩放结果
+    bool interactiveResize;    ///< 是否正在处理窗口缩放
+
+    /**
+     * @brief 将待显示日志一次性加入日志视图（界面线程）
+     */
+    inline void flushPendingLogs()
+    {
+        QStringList batch;
+        {
+            QMutexLocker locker(&pendingLogMutex);
+            batch.swap(pendingLogs);
+            logFlushScheduled.storeRelease(0);
+        }
+        if (currentMode != LogOutputMode || batch.isEmpty())
+            return;
+
+        QScrollBar *vScroll = logView->verticalScrollBar();
+        bool atBottom = vScroll->value() >= vScroll->maximum();
+        logModel->appendLines(batch);
+        if (atBottom) {
+            logView->scrollToBottom();
+        }
+    }
+
+    /**
+     * @brief 清空日志视图与待显示日志
+     */
+    inline void clearLogs()
+    {
+        {
+            QMutexLocker locker(&pendingLogMutex);
+            pendingLogs.clear();
+        }
+        logModel->clear();
+    }
+
     /**
      * @brief 显示提示
      */
@@ -335,6 +565,9 @@ private:
 
         iconLabel->hide();
         iconLabel->clear();
+        currentIconPath.clear();
+        currentIconKey.clear();
+        ++iconRequest;
         textLabel->setText(promptText);
         scrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
         scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
@@ -382,12 +615,10 @@ private:
     inline void showFileIcon(const QStringList &paths)
     {
         iconLabel->show();
-        QPixmap pix(filePath);
-        if (pix.isNull()) {
+        if (sourceIcon(filePath).isNull()) {
             qDebug() << "无法加载文件图标：" << filePath;
         }
-
-        iconLabel->setPixmap(pix);
+        currentIconPath = filePath;
 
         if (paths.size() == 1) {
             applySingleFileStyle(paths.first());
@@ -403,12 +634,10 @@ private:
     inline void showFolderIcon(const QStringList &paths)
     {
         iconLabel->show();
-        QPixmap pix(folderPath);
-        if (pix.isNull()) {
+        if (sourceIcon(folderPath).isNull()) {
             qDebug() << "无法加载文件夹图标：" << folderPath;
         }
-
-        iconLabel->setPixmap(pix);
+        currentIconPath = folderPath;
 
         if (paths.size() == 1) {
             applySingleFileStyle(paths.first());
@@ -463,34 +692,125 @@ private:
                 if (singleFileMode) {
                     f.setPointSize(singleFileFontSize);
                     textLabel->setFont(f);
-                    QPixmap pix = iconLabel->pixmap(Qt::ReturnByValue);
-                    if (!pix.isNull()) {
-                        QPixmap scaled = pix.scaled(largeIconSize, largeIconSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-                        iconLabel->setPixmap(scaled);
-                    }
+                    updateIcon(largeIconSize);
                     scrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
                 } else {
                     f.setPointSize(multiFileFontSize);
                     textLabel->setFont(f);
-                    QPixmap pix = iconLabel->pixmap(Qt::ReturnByValue);
-                    if (!pix.isNull()) {
-                        QPixmap scaled = pix.scaled(smallIconSize, smallIconSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-                        iconLabel->setPixmap(scaled);
-                    }
+                    updateIcon(smallIconSize);
                     scrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
                 }
             }
         } else if (currentMode == LogOutputMode) {
             int logFontSize = w / 30;
             f.setPointSize(logFontSize);
-            textLabel->setFont(f);
+            logView->setFont(f);
             iconLabel->hide();
-            scrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
         }
 
         scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     }
 
+    /**
+     * @brief 获取解码后的图标原图，每个路径只从磁盘解码一次，所有 DragArea 共享（界面线程）
+     *
+     * 按解码后的大小计入上限，超出时淘汰最久未使用的原图。
+     * @param path 图标路径
+     * @return 原图，加载失败时为空（不缓存，下次重新尝试）
+     */
+    static inline QImage sourceIcon(const QString &path)
+    {
+        static QCache<QString, QImage> sources(sourceIconLimitKB);
+        if (const QImage *cached = sources.object(path))
+            return *cached;
+
+        QImage image(path);
+        if (!image.isNull()) {
+            sources.insert(path, new QImage(image), qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+        }
+        return image;
+    }
+
+    /**
+     * @brief 缩放结果在 QPixmapCache 中的键
+     */
+    static inline QString iconCacheKey(const QString &path, int devicePixels, qreal ratio)
+    {
+        return QString("DragArea:%1:%2@%3").arg(path).arg(devicePixels).arg(ratio);
+    }
+
+    /**
+     * @brief 按指定逻辑尺寸显示当前图标
+     *
+     * 命中缓存时直接显示；否则先显示快速缩放的预览，再从原图平滑缩放（窗口缩放期间延迟到停止后）。
+     * @param logicalSize 图标边长（逻辑像素）
+     */
+    inline void updateIcon(int logicalSize)
+    {
+        if (currentIconPath.isEmpty())
+            return;
+
+        qreal ratio = devicePixelRatioF();
+        int devicePixels = qMax(1, qRound(logicalSize * ratio));
+        QString key = iconCacheKey(currentIconPath, devicePixels, ratio);
+        if (key == currentIconKey)
+            return;  // 已显示或正在平滑缩放同一尺寸
+        currentIconKey = key;
+        currentIconSize = devicePixels;
+        ++iconRequest;
+
+        QPixmap cached;
+        if (QPixmapCache::find(key, &cached)) {
+            iconScaleTimer->stop();
+            iconLabel->setPixmap(cached);
+            return;
+        }
+
+        QImage source = sourceIcon(currentIconPath);
+        if (source.isNull()) {
+            iconLabel->setPixmap(QPixmap());
+            return;
+        }
+        QPixmap preview = QPixmap::fromImage(source.scaled(devicePixels, devicePixels, Qt::KeepAspectRatio, Qt::FastTransformation));
+        preview.setDevicePixelRatio(ratio);
+        iconLabel->setPixmap(preview);
+
+        if (interactiveResize) {
+            iconScaleTimer->start();
+        } else {
+            iconScaleTimer->stop();
+            requestSmoothIcon();
+        }
+    }
+
+    /**
+     * @brief 在线程池中从原图平滑缩放当前图标，完成后放入缓存并显示
+     */
+    inline void requestSmoothIcon()
+    {
+        QImage source = sourceIcon(currentIconPath);
+        if (source.isNull())
+            return;
+
+        QPointer<DragArea> guard(this);
+        QString path = currentIconPath;
+        int devicePixels = currentIconSize;
+        qreal ratio = devicePixelRatioF();
+        quint64 request = iconRequest;
+        QThreadPool::globalInstance()->start([guard, source, path, devicePixels, ratio, request]() {
+            QImage scaled = source.scaled(devicePixels, devicePixels, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            // QPixmap 只能在界面线程中创建
+            QMetaObject::invokeMethod(qApp, [guard, scaled, path, devicePixels, ratio, request]() {
+                QPixmap pix = QPixmap::fromImage(scaled);
+                pix.setDevicePixelRatio(ratio);
+                QPixmapCache::insert(iconCacheKey(path, devicePixels, ratio), pix);
+                if (guard && guard->iconRequest == request) {
+                    guard->iconLabel->setPixmap(pix);
+                }
+            }, Qt::QueuedConnection);
+        });
+    }
+
     /**
      * @brief 每隔指定长度插入零宽空格的辅助函数
      * @param text 原始文本
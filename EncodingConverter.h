@@ -8,10 +8,43 @@
 #include <stdexcept>
 #include <regex>
 #include <filesystem>
-#include <future>
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <cstdint>
+#include <utility>
+#include <unordered_set>
+#include <unordered_map>
+#include <cctype>
+#include <string_view>
+#include <mutex>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <thread>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define ENCODINGCONVERTER_X86_SIMD
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ENCODINGCONVERTER_NEON_SIMD
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ThreadPool.h"
+#include "TimeCal.h"
 
 /**
  * @brief EncodingConverter 类
@@ -20,7 +53,7 @@
  * 支持通过正则表达式过滤文件和源编码。
  * 使用 uchardet 来检测编码，ICU (ucnv) 来执行编码转换。
  *
- * 通过重写 protected 的 logMessage 方法，可以实现自定义日志输出。
+ * 通过重写 protected 的 logMessage 方法，或通过 setLogSink() 设置日志输出对象，可以实现自定义日志输出。
  */
 class EncodingConverter {
 public:
@@ -30,294 +63,2330 @@ public:
     enum class LogLevel { INFO, WARN, ERROR };
 
     /**
-     * @brief 构造函数
+     * @brief 获取日志级别前缀
+     */
+    static inline const char* levelPrefix(LogLevel level)
+    {
+        switch (level) {
+        case LogLevel::INFO:
+            return "[INFO] ";
+        case LogLevel::WARN:
+            return "[WARN] ";
+        case LogLevel::ERROR:
+            return "[ERROR] ";
+        }
+        return "";
+    }
+
+    /**
+     * @brief 日志输出接口
+     *
+     * 通过 setLogSink() 设置后，默认的 logMessage 会把日志交给该对象。
+     * write 可能被多个工作线程并发调用，实现需自行保证线程安全。
+     */
+    class LogSink {
+    public:
+        virtual ~LogSink() = default;
+
+        /**
+         * @brief 输出一条日志
+         * @param level 日志级别
+         * @param message 日志信息
+         */
+        virtual void write(LogLevel level, const std::string& message) = 0;
+
+        /**
+         * @brief 刷新已缓冲的日志
+         */
+        virtual void flush() {}
+    };
+
+    /**
+     * @brief 输出到 std::ostream 的同步日志
+     *
+     * buffered 为 true 时日志先写入内部缓冲，缓冲超过 64 KB 或调用 flush() 时才一次性写出，
+     * 适合作为 AsyncLogSink 的下游。
+     */
+    class StreamLogSink : public LogSink {
+    public:
+        explicit StreamLogSink(std::ostream& stream, bool buffered = false)
+            : stream(stream), buffered(buffered)
+        {
+        }
+
+        ~StreamLogSink() override
+        {
+            flush();
+        }
+
+        void write(LogLevel level, const std::string& message) override
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.append(levelPrefix(level)).append(message).push_back('\n');
+            if (!buffered || pending.size() >= 64 * 1024) {
+                writePending();
+            }
+        }
+
+        void flush() override
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            writePending();
+        }
+
+    private:
+        inline void writePending()
+        {
+            if (!pending.empty()) {
+                stream.write(pending.data(), static_cast<std::streamsize>(pending.size()));
+                stream.flush();
+                pending.clear();
+            }
+        }
+
+        std::ostream& stream;   ///< 输出流
+        bool buffered;          ///< 是否缓冲
+        std::string pending;    ///< 待写出的日志
+        std::mutex mutex;       ///< 保护 pending 与 stream
+    };
+
+    /**
+     * @brief 有界的无锁多生产者单消费者日志队列
+     *
+     * 任意线程可并发调用 tryPush()；tryPop()、hasNext() 与 poppedCount() 只能由同一个消费线程调用。
+     */
+    class LogQueue {
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 队列容量，向上取整为 2 的幂
+         */
+        explicit LogQueue(size_t capacity = 8192)
+        {
+            size_t size = 2;
+            while (size < capacity) size <<= 1;
+            mask = size - 1;
+            cells.reset(new Cell[size]);
+            for (size_t i = 0; i < size; ++i) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        LogQueue(const LogQueue&) = delete;
+        LogQueue& operator=(const LogQueue&) = delete;
+
+        /**
+         * @brief 放入一条日志
+         * @return 队列已满时返回 false
+         */
+        inline bool tryPush(LogLevel level, const std::string& message)
+        {
+            size_t pos = enqueuePos.load(std::memory_order_relaxed);
+            Cell* cell = nullptr;
+            while (true) {
+                cell = &cells[pos & mask];
+                size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+            cell->level = level;
+            cell->message = message;
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief 取出一条日志（仅消费线程）
+         * @return 队列为空时返回 false
+         */
+        inline bool tryPop(LogLevel& level, std::string& message)
+        {
+            Cell& cell = cells[dequeuePos & mask];
+            if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+                return false;
+            }
+            level = cell.level;
+            message.swap(cell.message);
+            cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+            ++dequeuePos;
+            return true;
+        }
+
+        /**
+         * @brief 下一条日志是否已可取出（仅消费线程）
+         */
+        inline bool hasNext() const
+        {
+            return cells[dequeuePos & mask].sequence.load(std::memory_order_acquire) == dequeuePos + 1;
+        }
+
+        /**
+         * @brief 已放入（含正在放入）的日志总数
+         */
+        inline size_t pushedCount() const
+        {
+            return enqueuePos.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief 已取出的日志总数（仅消费线程）
+         */
+        inline size_t poppedCount() const
+        {
+            return dequeuePos;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence{ 0 };
+            LogLevel level = LogLevel::INFO;
+            std::string message;
+        };
+
+        std::unique_ptr<Cell[]> cells;                    ///< 环形队列
+        size_t mask = 0;                                  ///< 容量 - 1
+        alignas(64) std::atomic<size_t> enqueuePos{ 0 };  ///< 生产者位置
+        alignas(64) size_t dequeuePos = 0;                ///< 消费者位置
+    };
+
+    /**
+     * @brief 异步日志
+     *
+     * 工作线程把日志放入有界的无锁多生产者单消费者环形队列（LogQueue）后立即返回，
+     * 由后台线程批量取出并交给下游（默认为缓冲的 std::cerr）输出。
+     * 队列已满时按 OverflowPolicy 阻塞等待或丢弃（丢弃数可通过 droppedCount() 查询）。
+     */
+    class AsyncLogSink : public LogSink {
+    public:
+        /**
+         * @brief 队列已满时的处理方式
+         */
+        enum class OverflowPolicy {
+            Block,  ///< 让出 CPU 直到有空位（默认）
+            Drop    ///< 丢弃该条日志
+        };
+
+        /**
+         * @brief 构造函数，启动后台输出线程
+         * @param downstream 下游日志输出，为空时使用缓冲的 std::cerr
+         * @param capacity 队列容量，向上取整为 2 的幂
+         * @param policy 队列已满时的处理方式
+         */
+        explicit AsyncLogSink(std::shared_ptr<LogSink> downstream = nullptr, size_t capacity = 8192,
+                              OverflowPolicy policy = OverflowPolicy::Block)
+            : downstream(downstream ? std::move(downstream) : std::make_shared<StreamLogSink>(std::cerr, true)),
+            policy(policy),
+            queue(capacity)
+        {
+            consumer = std::thread([this]() { drainLoop(); });
+        }
+
+        AsyncLogSink(const AsyncLogSink&) = delete;
+        AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+        /**
+         * @brief 析构函数，输出队列中剩余的日志后停止后台线程
+         */
+        ~AsyncLogSink() override
+        {
+            stopping.store(true, std::memory_order_release);
+            wakeConsumer();
+            if (consumer.joinable()) {
+                consumer.join();
+            }
+        }
+
+        void write(LogLevel level, const std::string& message) override
+        {
+            while (!queue.tryPush(level, message)) {
+                if (policy == OverflowPolicy::Drop) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                wakeConsumer();
+                std::this_thread::yield();
+            }
+            if (consumerSleeping.load(std::memory_order_acquire)) {
+                wakeConsumer();
+            }
+        }
+
+        /**
+         * @brief 阻塞直到此前写入的日志全部交给下游并刷新
+         */
+        void flush() override
+        {
+            size_t target = queue.pushedCount();
+            while (drainedPos.load(std::memory_order_acquire) < target) {
+                wakeConsumer();
+                std::this_thread::yield();
+            }
+            downstream->flush();
+        }
+
+        /**
+         * @brief 因队列已满被丢弃的日志条数
+         */
+        inline size_t droppedCount() const
+        {
+            return dropped.load(std::memory_order_relaxed);
+        }
+
+    private:
+        inline void wakeConsumer()
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            wakeCondition.notify_one();
+        }
+
+        inline void drainLoop()
+        {
+            LogLevel level;
+            std::string message;
+            while (true) {
+                bool any = false;
+                while (queue.tryPop(level, message)) {
+                    downstream->write(level, message);
+                    any = true;
+                }
+                if (any) {
+                    downstream->flush();
+                    drainedPos.store(queue.poppedCount(), std::memory_order_release);
+                    continue;
+                }
+                drainedPos.store(queue.poppedCount(), std::memory_order_release);
+                if (stopping.load(std::memory_order_acquire) && queue.poppedCount() == queue.pushedCount()) {
+                    return;
+                }
+
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                consumerSleeping.store(true, std::memory_order_release);
+                wakeCondition.wait_for(lock, std::chrono::milliseconds(50), [&]() {
+                    return stopping.load(std::memory_order_acquire) || queue.hasNext();
+                });
+                consumerSleeping.store(false, std::memory_order_release);
+            }
+        }
+
+        std::shared_ptr<LogSink> downstream;          ///< 下游日志输出
+        OverflowPolicy policy;                        ///< 队列已满时的处理方式
+        LogQueue queue;                               ///< 日志队列
+
+        std::atomic<size_t> drainedPos{ 0 };               ///< 已交给下游的位置
+        std::atomic<size_t> dropped{ 0 };                  ///< 丢弃的日志条数
+        std::atomic<bool> stopping{ false };               ///< 是否正在停止
+        std::atomic<bool> consumerSleeping{ false };       ///< 后台线程是否在等待
+
+        std::mutex wakeMutex;                         ///< 仅用于唤醒后台线程
+        std::condition_variable wakeCondition;        ///< 唤醒后台线程
+        std::thread consumer;                         ///< 后台输出线程
+    };
+
+    /**
+     * @brief 单个文件的处理结果
+     */
+    enum class FileResult : std::uint8_t {
+        Converted,      ///< 已转换并写回
+        AlreadyTarget,  ///< 已是目标编码，未写入
+        Skipped,        ///< 编码未知、不匹配过滤器或不受支持，未处理
+        Unchanged,      ///< 自上次运行以来未变化（清单命中），未检测与转换（默认只 stat，未读取）
+        Failed          ///< 处理失败
+    };
+
+    /**
+     * @brief 各阶段累计耗时（秒，多线程时为各线程耗时之和）
+     *
+     * 输入通过 mmap 读取，页面在首次访问时才真正读盘，因此 read 包含映射与首遍 UTF-8 校验。
+     */
+    struct PhaseTimings {
+        double walk = 0;      ///< 目录遍历与文件过滤
+        double read = 0;      ///< 打开、映射文件及首遍校验
+        double detect = 0;    ///< 编码检测
+        double convert = 0;   ///< 编码转换（流式转换包含写入临时文件）
+        double write = 0;     ///< 写回或替换原文件
+    };
+
+    /**
+     * @brief 单个文件的扫描信息
+     */
+    struct FileReport {
+        std::string path;                          ///< 文件路径
+        std::string encoding;                      ///< 检测到的编码
+        double confidence = -1;                    ///< 检测置信度（0~1），小于 0 表示不可用
+        std::uintmax_t bytes = 0;                  ///< 文件大小
+        FileResult result = FileResult::Failed;    ///< 处理结果（扫描时表示将会得到的结果）
+    };
+
+    /**
+     * @brief 一次扫描或转换的结构化报告
+     */
+    struct ConversionReport {
+        std::vector<FileReport> files;                      ///< 逐文件信息，仅 scan 填充
+        std::map<std::string, size_t> encodingCounts;       ///< 各检测编码的文件数
+        std::map<FileResult, size_t> resultCounts;          ///< 各处理结果的文件数
+        PhaseTimings timings;                               ///< 各阶段累计耗时
+        size_t fileCount = 0;                               ///< 已处理文件数
+        std::uintmax_t totalBytes = 0;                      ///< 已读取的字节数
+        double elapsedSeconds = 0;                          ///< 墙钟耗时
+
+        /**
+         * @brief 吞吐量（MB/s）
+         */
+        inline double throughputMBps() const
+        {
+            return elapsedSeconds > 0 ? static_cast<double>(totalBytes) / (1024.0 * 1024.0) / elapsedSeconds : 0;
+        }
+
+        /**
+         * @brief 每秒处理的文件数
+         */
+        inline double filesPerSecond() const
+        {
+            return elapsedSeconds > 0 ? static_cast<double>(fileCount) / elapsedSeconds : 0;
+        }
+    };
+
+    /**
+     * @brief 编码检测选项
+     *
+     * 默认按块送入整个文件。设置采样区间后，大文件只检测头部、中部和尾部；
+     * 设置 confidenceBytes 后，在出现非 ASCII 字节并继续送入该数量的字节后提前结束检测。
+     */
+    struct DetectionOptions {
+        size_t chunkSize = 64 * 1024;         ///< 每次送入 uchardet 的块大小
+        std::uintmax_t confidenceBytes = 0;   ///< 首个非 ASCII 字节后再检测的字节数，0 表示不提前结束
+        std::uintmax_t headBytes = 0;         ///< 采样：文件头部字节数
+        std::uintmax_t middleBytes = 0;       ///< 采样：文件中部字节数
+        std::uintmax_t tailBytes = 0;         ///< 采样：文件尾部字节数
+    };
+
+    /**
+     * @brief 预编译的过滤器
+     *
+     * 在每次 convert 调用开始时编译一次，之后只读，可被所有工作线程共享。
+     * 过滤串形如 "cpp|h|txt"、只包含普通字符时使用哈希集合匹配，否则编译为 std::regex。
+     * 匹配均不区分大小写。
+     */
+    class FilterMatcher {
+    public:
+        /**
+         * @brief 匹配方式
+         */
+        enum class Mode {
+            Extension, ///< 匹配文件扩展名，等价于 "^.*\.(filter)$"
+            Whole      ///< 匹配整个名称，等价于 "^(filter)$"
+        };
+
+        /**
+         * @brief 构造空过滤器，匹配一切
+         */
+        FilterMatcher() = default;
+
+        /**
+         * @brief 编译过滤器
+         * @param filter 过滤串（正则表达式），为空则匹配一切
+         * @param mode 匹配方式
+         * @throw std::regex_error 过滤串不是合法的正则表达式
+         */
+        FilterMatcher(const std::string& filter, Mode mode)
+            : pattern(filter), mode(mode)
+        {
+            if (filter.empty()) {
+                return;
+            }
+
+            if (isLiteralList(filter)) {
+                size_t begin = 0;
+                while (begin <= filter.size()) {
+                    size_t end = filter.find('|', begin);
+                    if (end == std::string::npos) end = filter.size();
+                    literals.insert(toLower(filter.substr(begin, end - begin)));
+                    begin = end + 1;
+                }
+                return;
+            }
+
+            std::string regexPattern = mode == Mode::Extension ? "^.*\\.(" + filter + ")$" : "^(" + filter + ")$";
+            regex = std::make_shared<const std::regex>(regexPattern, std::regex_constants::ECMAScript | std::regex_constants::icase);
+        }
+
+        /**
+         * @brief 是否为空过滤器
+         */
+        inline bool empty() const
+        {
+            return pattern.empty();
+        }
+
+        /**
+         * @brief 获取原始过滤串
+         */
+        inline const std::string& str() const
+        {
+            return pattern;
+        }
+
+        /**
+         * @brief 判断名称是否通过过滤
+         * @param name 文件名或编码名
+         */
+        inline bool matches(const std::string& name) const
+        {
+            if (pattern.empty()) {
+                return true;
+            }
+            if (regex) {
+                return std::regex_match(name, *regex);
+            }
+
+            if (mode == Mode::Extension) {
+                // 字面量中不含 '.'，因此只可能与最后一个 '.' 之后的部分相等
+                size_t dot = name.rfind('.');
+                return dot != std::string::npos && literals.count(toLower(name.substr(dot + 1))) > 0;
+            }
+            return literals.count(toLower(name)) > 0;
+        }
+
+    private:
+        static inline bool isLiteralList(const std::string& filter)
+        {
+            bool tokenEmpty = true;
+            for (char c : filter) {
+                if (c == '|') {
+                    if (tokenEmpty) return false;
+                    tokenEmpty = true;
+                } else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-') {
+                    tokenEmpty = false;
+                } else {
+                    return false;
+                }
+            }
+            return !tokenEmpty;
+        }
+
+        static inline std::string toLower(std::string text)
+        {
+            std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) {
+                return static_cast<char>(std::tolower(c));
+            });
+            return text;
+        }
+
+        std::string pattern;                          ///< 原始过滤串
+        Mode mode = Mode::Whole;                      ///< 匹配方式
+        std::unordered_set<std::string> literals;     ///< 字面量集合（小写）
+        std::shared_ptr<const std::regex> regex;      ///< 非字面量过滤串编译后的正则
+    };
+
+    /**
+     * @brief 构造函数
+     */
+    EncodingConverter() = default;
+
+    /**
+     * @brief 设置日志输出对象
+     *
+     * 默认的 logMessage 会把日志交给该对象；子类重写 logMessage 时不受影响。
+     * @param sink 日志输出，为空时恢复输出到 std::cerr
+     */
+    inline void setLogSink(std::shared_ptr<LogSink> sink)
+    {
+        std::atomic_store(&logSink, std::move(sink));
+    }
+
+    /**
+     * @brief 设置最低日志级别，低于该级别的日志在拼接字符串之前即被丢弃
+     * @param level 最低日志级别，默认为 INFO（输出全部日志）
+     */
+    inline void setLogLevel(LogLevel level)
+    {
+        minimumLevel.store(level, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 判断指定级别的日志是否会被输出
+     */
+    inline bool isLogEnabled(LogLevel level) const
+    {
+        return static_cast<int>(level) >= static_cast<int>(minimumLevel.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief 设置多线程转换时的工作线程数
+     * @param count 工作线程数，为 0 时使用 std::thread::hardware_concurrency()
+     */
+    inline void setWorkerCount(size_t count)
+    {
+        workerCount = count;
+    }
+
+    /**
+     * @brief 设置多线程转换时等待处理的文件队列上限
+     *
+     * 目录遍历线程在队列已满时会暂停，保证内存占用不随目录规模增长。
+     * @param capacity 队列上限，为 0 时取工作线程数的 64 倍
+     */
+    inline void setQueueCapacity(size_t capacity)
+    {
+        queueCapacity = capacity;
+    }
+
+    /**
+     * @brief 设置流式转换的文件大小阈值
+     *
+     * 不小于该阈值的文件按固定大小的块流式检测与转换，写入临时文件后原子替换原文件，
+     * 峰值内存与文件大小无关。
+     * @param bytes 阈值（字节），默认 64 MB
+     */
+    inline void setStreamingThreshold(std::uintmax_t bytes)
+    {
+        streamingThreshold = bytes;
+    }
+
+    /**
+     * @brief 设置流式转换时每次读取的块大小
+     * @param bytes 块大小（字节），默认 1 MB
+     */
+    inline void setStreamChunkSize(size_t bytes)
+    {
+        streamChunkSize = std::max<size_t>(bytes, 4096);
+    }
+
+    /**
+     * @brief 设置是否跳过无需转换的文件
+     *
+     * 启用时（默认），纯 7 位 ASCII 文件在目标编码兼容 ASCII 时直接跳过，
+     * 目标为 UTF-8 且文件已是合法 UTF-8 时同样跳过，不做检测、转换与写入。
+     * @param enabled 是否启用
+     */
+    inline void setFastSkip(bool enabled)
+    {
+        fastSkip = enabled;
+    }
+
+    /**
+     * @brief 设置编码检测选项
+     * @param options 检测选项，头部/中部/尾部全为 0 时检测整个文件
+     */
+    inline void setDetectionOptions(const DetectionOptions& options)
+    {
+        detectionOptions = options;
+        detectionOptions.chunkSize = std::max<size_t>(detectionOptions.chunkSize, 4096);
+    }
+
+    /**
+     * @brief 设置增量转换清单文件
+     *
+     * 启用后，每次运行开始时加载清单，大小与修改时间均未变化的文件只需一次 stat 即被跳过
+     * （启用 setManifestVerifyContent() 时还需读取一遍比对内容哈希）；
+     * 运行结束时清单以临时文件加重命名的方式原子更新。
+     * 目标编码或源编码过滤器与上次运行不同时，旧清单作废。
+     * @param path 清单文件路径，为空则不使用清单（默认）
+     */
+    inline void setManifestPath(const std::string& path)
+    {
+        manifestPath = path;
+    }
+
+    /**
+     * @brief 设置清单命中时是否还比对内容哈希
+     *
+     * 启用后，处理文件时额外计算内容哈希记入清单；大小与修改时间一致的文件还要读取一遍比对哈希，
+     * 可发现修改时间精度不足或被还原时遗漏的改动，但免去的只是检测与转换。
+     * 清单中没有哈希的记录（在关闭时写入）视为已变化，重新处理一次。
+     * @param enabled 是否比对内容哈希，默认为 false（只 stat）
+     */
+    inline void setManifestVerifyContent(bool enabled)
+    {
+        manifestVerifyContent = enabled;
+    }
+
+    /**
+     * @brief 将指定路径（文件或目录）中的文件转换为指定编码（线程池多线程处理）
+     * @param path 要处理的文件或目录路径
+     * @param toEncoding 目标编码
+     * @param sourceEncodingFilter 源编码过滤器（正则表达式），为空则不过滤
+     * @param fileFilter 文件过滤规则（正则表达式），为空则不过滤
+     */
+    inline void convert(
+        const std::string& path,
+        const std::string& toEncoding,
+        const std::string& sourceEncodingFilter = "",
+        const std::string& fileFilter = ""
+        ) {
+        RunContext context = beginRun(toEncoding, sourceEncodingFilter);
+        const FilterMatcher fileMatcher = compileFilter(fileFilter, FilterMatcher::Mode::Extension);
+
+        {
+            ThreadPool pool(workerCount, queueCapacity);
+            walkPath(path, fileMatcher, [&](const std::string& filePath) {
+                pool.submit([this, filePath, &context]() {
+                    processFile(filePath, context);
+                });
+            });
+            pool.waitIdle();
+        }
+        endRun(context);
+
+        // logMessage(LogLevel::INFO, "Conversion process completed.");
+    }
+
+    /**
+     * @brief 单个文件处理完成时的回调，参数为文件路径与处理结果
+     */
+    using FileCallback = std::function<void(const std::string& filePath, FileResult result)>;
+
+    /**
+     * @brief 批量转换给定的文件列表（线程池多线程处理）
+     *
+     * 适用于已知变更文件集合的场景（如来自版本控制）。所有文件先被收集并按大小降序调度，
+     * 大文件尽早开始，以缩短整体的尾部耗时。列表中的目录会被递归展开，重复的文件只处理一次，
+     * 不存在的路径记录警告后跳过。
+     * @param first 路径区间起点，元素需可转换为 std::string
+     * @param last 路径区间终点
+     * @param toEncoding 目标编码
+     * @param sourceEncodingFilter 源编码过滤器（正则表达式），为空则不过滤
+     * @param fileFilter 文件过滤规则（正则表达式），为空则不过滤
+     * @param onFileDone 单个文件处理完成时的回调（在工作线程中调用，需线程安全），可为空
+     */
+    template <typename InputIt>
+    inline void convertFiles(
+        InputIt first,
+        InputIt last,
+        const std::string& toEncoding,
+        const std::string& sourceEncodingFilter = "",
+        const std::string& fileFilter = "",
+        FileCallback onFileDone = nullptr
+        ) {
+        namespace fs = std::filesystem;
+        RunContext context = beginRun(toEncoding, sourceEncodingFilter);
+        const FilterMatcher fileMatcher = compileFilter(fileFilter, FilterMatcher::Mode::Extension);
+
+        std::vector<std::pair<std::uintmax_t, std::string>> files;
+        std::unordered_set<std::string> seen;
+        for (; first != last; ++first) {
+            std::string path(*first);
+            std::error_code ec;
+            if (!fs::exists(path, ec)) {
+                writeLog(LogLevel::WARN, "Skipping missing path: ", path);
+                continue;
+            }
+            if (!fs::is_directory(path, ec) && !fs::is_regular_file(path, ec)) {
+                writeLog(LogLevel::WARN, "Skipping non-regular file: ", path);
+                continue;
+            }
+            // 遍历出错（如目录无权限）只跳过该路径，与单个文件转换失败的处理方式一致
+            try {
+                walkPath(path, fileMatcher, [&](const std::string& filePath) {
+                    // 列表中的文件与目录可能重叠，同一文件只处理一次，避免并发写入
+                    if (seen.insert(fs::absolute(filePath, ec).lexically_normal().string()).second) {
+                        files.emplace_back(0, filePath);
+                    }
+                });
+            }
+            catch (const std::exception& e) {
+                writeLog(LogLevel::ERROR, "Error walking ", path, ": ", e.what());
+            }
+        }
+
+        {
+            // 遍历耗时已由 walkPath 计入 walk 阶段，排序只计入剖析统计
+            HEADONLY_PROFILE_SCOPE("EncodingConverter::sortFiles");
+            for (auto& file : files) {
+                std::error_code ec;
+                std::uintmax_t size = fs::file_size(file.second, ec);
+                file.first = ec ? 0 : size;
+            }
+            std::stable_sort(files.begin(), files.end(), [](const auto& a, const auto& b) {
+                return a.first > b.first;
+            });
+        }
+
+        {
+            ThreadPool pool(workerCount, queueCapacity);
+            for (auto& file : files) {
+                pool.submit([this, filePath = std::move(file.second), &context, &onFileDone]() {
+                    FileResult result = processFile(filePath, context);
+                    if (onFileDone) {
+                        onFileDone(filePath, result);
+                    }
+                });
+            }
+            pool.waitIdle();
+        }
+        endRun(context);
+    }
+
+    /**
+     * @brief 批量转换给定的文件列表，参见迭代器区间版本
+     */
+    inline void convertFiles(
+        const std::vector<std::string>& paths,
+        const std::string& toEncoding,
+        const std::string& sourceEncodingFilter = "",
+        const std::string& fileFilter = "",
+        FileCallback onFileDone = nullptr
+        ) {
+        convertFiles(paths.begin(), paths.end(), toEncoding, sourceEncodingFilter, fileFilter, std::move(onFileDone));
+    }
+
+    /**
+     * @brief 扫描指定路径（演练模式），返回结构化报告，不修改任何文件
+     *
+     * 执行与 convert 相同的检测与内存转换流程（线程池多线程处理），但不写回文件，
+     * 也不读取或更新增量转换清单，可用于评估转换任务规模与发现性能回退。
+     * @param path 要扫描的文件或目录路径
+     * @param toEncoding 目标编码
+     * @param sourceEncodingFilter 源编码过滤器（正则表达式），为空则不过滤
+     * @param fileFilter 文件过滤规则（正则表达式），为空则不过滤
+     * @return 包含逐文件信息、编码统计、阶段耗时与吞吐量的报告
+     */
+    inline ConversionReport scan(
+        const std::string& path,
+        const std::string& toEncoding,
+        const std::string& sourceEncodingFilter = "",
+        const std::string& fileFilter = ""
+        ) {
+        RunContext context = beginRun(toEncoding, sourceEncodingFilter, true);
+        const FilterMatcher fileMatcher = compileFilter(fileFilter, FilterMatcher::Mode::Extension);
+
+        {
+            ThreadPool pool(workerCount, queueCapacity);
+            walkPath(path, fileMatcher, [&](const std::string& filePath) {
+                pool.submit([this, filePath, &context]() {
+                    processFile(filePath, context);
+                });
+            });
+            pool.waitIdle();
+        }
+        endRun(context);
+
+        ConversionReport report = context.statistics->snapshot();
+        report.files = std::move(context.statistics->files);
+        return report;
+    }
+
+    /**
+     * @brief 获取最近一次（或正在进行的）convert/scan 的汇总统计，不含逐文件信息
+     *
+     * 可在转换进行中从其他线程调用，用于显示进度。
+     */
+    inline ConversionReport statistics() const
+    {
+        std::shared_ptr<RunStatistics> current = std::atomic_load(&lastStatistics);
+        return current ? current->snapshot() : ConversionReport();
+    }
+
+    /**
+     * @brief 以单线程方式处理指定路径文件的转换（不使用线程池）
+     * @param path 路径（文件或目录）
+     * @param toEncoding 目标编码
+     * @param sourceEncodingFilter 源编码过滤器（可选）
+     * @param fileFilter 文件过滤（可选）
+     */
+    inline void convert_single(
+        const std::string& path,
+        const std::string& toEncoding,
+        const std::string& sourceEncodingFilter = "",
+        const std::string& fileFilter = ""
+        ) {
+        RunContext context = beginRun(toEncoding, sourceEncodingFilter);
+        const FilterMatcher fileMatcher = compileFilter(fileFilter, FilterMatcher::Mode::Extension);
+
+        walkPath(path, fileMatcher, [&](const std::string& filePath) {
+            processFile(filePath, context);
+        });
+        endRun(context);
+
+        // logMessage(LogLevel::INFO, "Conversion process completed.");
+    }
+
+protected:
+    /**
+     * @brief 可重写的日志函数，子类可重写此函数实现自定义日志输出
+     * @param level 日志级别
+     * @param message 日志信息
+     */
+    virtual void logMessage(LogLevel level, const std::string& message) {
+        std::shared_ptr<LogSink> sink = std::atomic_load(&logSink);
+        if (sink) {
+            sink->write(level, message);
+            return;
+        }
+
+        std::string line = levelPrefix(level) + message + '\n';
+        std::cerr.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+
+    /**
+     * @brief 先检查日志级别，再拼接各部分并调用 logMessage
+     * @param level 日志级别
+     * @param parts 日志各部分（可转换为 std::string_view 的对象）
+     */
+    template <typename... Parts>
+    inline void writeLog(LogLevel level, const Parts&... parts)
+    {
+        if (!isLogEnabled(level)) {
+            return;
+        }
+        std::string message;
+        message.reserve((std::string_view(parts).size() + ... + 0));
+        (message.append(std::string_view(parts)), ...);
+        logMessage(level, message);
+    }
+
+private:
+    size_t workerCount = 0;     ///< 工作线程数，0 表示使用硬件并发数
+    size_t queueCapacity = 0;   ///< 待处理文件队列上限，0 表示自动
+    std::uintmax_t streamingThreshold = 64ull * 1024 * 1024;  ///< 流式转换阈值
+    size_t streamChunkSize = 1024 * 1024;                      ///< 流式转换块大小
+    DetectionOptions detectionOptions;                         ///< 编码检测选项
+    bool fastSkip = true;                                      ///< 是否跳过无需转换的文件
+    std::string manifestPath;                                  ///< 增量转换清单路径，为空表示不使用
+    bool manifestVerifyContent = false;                        ///< 清单命中时是否还比对内容哈希
+
+    struct RunStatistics;
+    std::shared_ptr<RunStatistics> lastStatistics;             ///< 最近一次运行的统计（原子读写）
+    std::shared_ptr<LogSink> logSink;                          ///< 日志输出对象（原子读写），为空输出到 std::cerr
+    std::atomic<LogLevel> minimumLevel{ LogLevel::INFO };      ///< 最低日志级别
+
+    /// 内存转换允许的最大输入，更大的文件总是走流式路径
+    static constexpr std::uintmax_t maxInMemorySize = (INT32_MAX - 1) / 4;
+
+    /// 流式转换临时文件的后缀；临时文件是以 '.' 开头的同目录隐藏文件，遍历时总是跳过
+    static constexpr std::string_view tempFileSuffix = ".encconv.tmp";
+
+    /**
+     * @brief 流式转换使用的临时文件路径（与原文件同目录，保证 rename 不跨文件系统）
+     */
+    static inline std::string tempPathFor(const std::string& filePath)
+    {
+        std::filesystem::path path(filePath);
+        std::string name = "." + path.filename().string();
+        name += tempFileSuffix;
+        return (path.parent_path() / name).string();
+    }
+
+    /**
+     * @brief 映射目标编码名称，不支持时抛出异常
+     * @param toEncoding 目标编码
+     * @return 映射后的编码名称
+     */
+    inline std::string mapTargetEncoding(const std::string& toEncoding)
+    {
+        std::string mappedToEncoding = mapEncodingName(toEncoding);
+        if (mappedToEncoding.empty()) {
+            writeLog(LogLevel::ERROR, "Unsupported target encoding: ", toEncoding);
+            throw std::runtime_error("Unsupported target encoding: " + toEncoding);
+        }
+        writeLog(LogLevel::INFO, "Target Encoding Mapped: ", mappedToEncoding);
+        return mappedToEncoding;
+    }
+
+    /**
+     * @brief 遍历路径（文件或目录），对每个通过文件过滤的文件调用 handle
+     * @param path 路径（文件或目录）
+     * @param fileFilter 预编译的文件过滤器
+     * @param handle 处理单个文件路径的回调
+     */
+    template <typename Handler>
+    inline void walkPath(const std::string& path, const FilterMatcher& fileFilter, Handler&& handle)
+    {
+        namespace fs = std::filesystem;
+        fs::path inputPath(path);
+
+        // 遍历耗时 = 总耗时 - 回调耗时（回调可能因队列已满而阻塞，不计入遍历）
+        std::shared_ptr<RunStatistics> stats = std::atomic_load(&lastStatistics);
+        std::chrono::steady_clock::duration handlerTime{};
+        auto walkStart = std::chrono::steady_clock::now();
+        auto timedHandle = [&](const std::string& filePath) {
+            auto handlerStart = std::chrono::steady_clock::now();
+            handle(filePath);
+            handlerTime += std::chrono::steady_clock::now() - handlerStart;
+        };
+        struct WalkTimer {
+            RunStatistics* stats;
+            std::chrono::steady_clock::time_point& start;
+            std::chrono::steady_clock::duration& excluded;
+            ~WalkTimer() {
+                if (stats) stats->add(stats->walkNs, std::chrono::steady_clock::now() - start - excluded);
+            }
+        } walkTimer{ stats.get(), walkStart, handlerTime };
+
+        if (fs::is_directory(inputPath)) {
+            writeLog(LogLevel::INFO, "Processing directory: ", inputPath.string());
+            for (const auto& entry : fs::recursive_directory_iterator(inputPath)) {
+                if (entry.is_regular_file()) {
+                    std::string fileName = entry.path().filename().string();
+                    if (shouldProcessFile(fileName, fileFilter)) {
+                        timedHandle(entry.path().string());
+                    }
+                } else {
+                    writeLog(LogLevel::WARN, "Skipping non-regular file: ", entry.path().string());
+                }
+            }
+        } else if (fs::is_regular_file(inputPath)) {
+            std::string fileName = inputPath.filename().string();
+            if (shouldProcessFile(fileName, fileFilter)) {
+                writeLog(LogLevel::INFO, "Processing single file: ", inputPath.string());
+                timedHandle(inputPath.string());
+            } else {
+                writeLog(LogLevel::WARN, "File does not match filter and will be skipped: ", inputPath.string());
+            }
+        } else {
+            writeLog(LogLevel::ERROR, "Invalid path: ", path);
+            throw std::runtime_error("Invalid path: " + path);
+        }
+    }
+
+    /**
+     * @brief 单个文件的处理结果及其附带信息
+     */
+    struct FileOutcome {
+        FileResult result = FileResult::Failed;   ///< 处理结果
+        std::string encoding;                     ///< 检测到的编码（已映射），快速跳过时为目标编码
+        std::uint64_t hash = 0;                   ///< 处理后文件内容的哈希，0 表示未计算
+        double confidence = -1;                   ///< 检测置信度，小于 0 表示不可用
+        std::uintmax_t bytes = 0;                 ///< 读取的文件大小
+    };
+
+    /**
+     * @brief 一次运行的统计，工作线程通过原子计数并发累加
+     */
+    struct RunStatistics {
+        std::atomic<std::uint64_t> walkNs{ 0 };
+        std::atomic<std::uint64_t> readNs{ 0 };
+        std::atomic<std::uint64_t> detectNs{ 0 };
+        std::atomic<std::uint64_t> convertNs{ 0 };
+        std::atomic<std::uint64_t> writeNs{ 0 };
+        std::atomic<std::uint64_t> fileCount{ 0 };
+        std::atomic<std::uint64_t> byteCount{ 0 };
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::atomic<std::int64_t> elapsedNs{ -1 };   ///< 运行结束时写入，-1 表示仍在进行
+
+        std::mutex mutex;                                  ///< 保护以下容器
+        std::map<std::string, size_t> encodingCounts;
+        std::map<FileResult, size_t> resultCounts;
+        bool collectFiles = false;                         ///< 是否记录逐文件信息（scan）
+        std::vector<FileReport> files;
+
+        inline void add(std::atomic<std::uint64_t>& counter, std::chrono::steady_clock::duration elapsed)
+        {
+            counter.fetch_add(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                              std::memory_order_relaxed);
+        }
+
+        inline void addFile(const std::string& path, const FileOutcome& outcome)
+        {
+            fileCount.fetch_add(1, std::memory_order_relaxed);
+            byteCount.fetch_add(outcome.bytes, std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            ++resultCounts[outcome.result];
+            if (!outcome.encoding.empty()) {
+                ++encodingCounts[outcome.encoding];
+            }
+            if (collectFiles) {
+                files.push_back({ path, outcome.encoding, outcome.confidence, outcome.bytes, outcome.result });
+            }
+        }
+
+        inline ConversionReport snapshot()
+        {
+            auto seconds = [](const std::atomic<std::uint64_t>& ns) {
+                return static_cast<double>(ns.load(std::memory_order_relaxed)) / 1e9;
+            };
+            ConversionReport report;
+            report.timings.walk = seconds(walkNs);
+            report.timings.read = seconds(readNs);
+            report.timings.detect = seconds(detectNs);
+            report.timings.convert = seconds(convertNs);
+            report.timings.write = seconds(writeNs);
+            report.fileCount = static_cast<size_t>(fileCount.load(std::memory_order_relaxed));
+            report.totalBytes = byteCount.load(std::memory_order_relaxed);
+
+            std::int64_t elapsed = elapsedNs.load(std::memory_order_acquire);
+            report.elapsedSeconds = elapsed >= 0
+                ? static_cast<double>(elapsed) / 1e9
+                : std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            report.encodingCounts = encodingCounts;
+            report.resultCounts = resultCounts;
+            return report;
+        }
+    };
+
+    /**
+     * @brief 作用域计时器，析构时把耗时累加到指定计数器
+     */
+    class PhaseTimer {
+    public:
+        PhaseTimer(RunStatistics& stats, std::atomic<std::uint64_t>& counter)
+            : stats(stats), counter(counter), start(std::chrono::steady_clock::now())
+        {
+        }
+        ~PhaseTimer()
+        {
+            stats.add(counter, std::chrono::steady_clock::now() - start);
+        }
+
+    private:
+        RunStatistics& stats;
+        std::atomic<std::uint64_t>& counter;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    /**
+     * @brief 增量计算的 64 位内容哈希（非密码学用途），每次处理 8 字节
+     */
+    class ContentHasher {
+    public:
+        inline void update(const char* data, size_t size)
+        {
+            total += size;
+            if (fill > 0) {
+                size_t take = std::min(sizeof(buffer) - fill, size);
+                std::memcpy(buffer + fill, data, take);
+                fill += take;
+                data += take;
+                size -= take;
+                if (fill < sizeof(buffer)) {
+                    return;
+                }
+                mix(load(buffer));
+                fill = 0;
+            }
+            for (; size >= 8; data += 8, size -= 8) {
+                mix(load(data));
+            }
+            std::memcpy(buffer, data, size);
+            fill = size;
+        }
+
+        inline std::uint64_t digest() const
+        {
+            std::uint64_t h = state;
+            if (fill > 0) {
+                std::uint64_t word = 0;
+                std::memcpy(&word, buffer, fill);
+                h = rotl(h ^ (word * k1), 31) * k2;
+            }
+            h ^= total;
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h | 1;   // 保留 0 表示“未计算”
+        }
+
+    private:
+        static constexpr std::uint64_t k1 = 0x87c37b91114253d5ULL;
+        static constexpr std::uint64_t k2 = 0x4cf5ad432745937fULL;
+
+        static inline std::uint64_t rotl(std::uint64_t x, int r)
+        {
+            return (x << r) | (x >> (64 - r));
+        }
+        static inline std::uint64_t load(const char* p)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            return word;
+        }
+        inline void mix(std::uint64_t word)
+        {
+            state = rotl(state ^ (word * k1), 31) * k2 + 0x52dce729;
+        }
+
+        std::uint64_t state = 0x9368e53c2f6af274ULL;  ///< 当前状态
+        std::uint64_t total = 0;                      ///< 已输入字节数
+        char buffer[8] = {};                          ///< 不足 8 字节的尾部
+        size_t fill = 0;                              ///< buffer 中的字节数
+    };
+
+    static inline std::uint64_t contentHash(std::string_view data)
+    {
+        ContentHasher hasher;
+        hasher.update(data.data(), data.size());
+        return hasher.digest();
+    }
+
+    /**
+     * @brief 增量转换清单
+     *
+     * 记录每个文件上次处理后的大小、修改时间、内容哈希、检测编码与处理结果。
+     * 加载后的旧记录在运行期间只读，可被工作线程并发查询；新记录在互斥锁下写入。
+     * 默认大小与修改时间一致即视为未变化，只需一次 stat；启用内容校验时还会比对内容哈希
+     * （需读取一遍文件，但免去检测与转换），以发现修改时间精度不足或被还原时遗漏的改动。
+     * 保存时保留本次未涉及但仍存在的文件的旧记录，部分运行（convertFiles、中途失败）不会丢失其他文件的记录。
+     *
+     * 二进制格式（本机字节序）：
+     * "ECMF" | u32 版本 | u32 任务键长度 + 任务键 | u64 记录数 |
+     * 每条记录：u32 路径长度 + 路径 | u64 大小 | i64 修改时间 | u64 哈希 | u8 结果 | u8 编码长度 + 编码
+     */
+    class ConversionManifest {
+    public:
+        struct Entry {
+            std::uint64_t size = 0;                  ///< 文件大小
+            std::int64_t mtime = 0;                  ///< 修改时间（file_time_type 计数）
+            std::uint64_t hash = 0;                  ///< 内容哈希，0 表示未计算
+            FileResult result = FileResult::Failed;  ///< 处理结果
+            std::string encoding;                    ///< 检测到的编码
+        };
+
+        ConversionManifest(const std::string& path, const std::string& jobKey, bool verifyContent = false)
+            : path(path), jobKey(jobKey), verifyContent(verifyContent)
+        {
+        }
+
+        /**
+         * @brief 是否比对内容哈希（需要为记录计算哈希）
+         */
+        inline bool verifiesContent() const
+        {
+            return verifyContent;
+        }
+
+        /**
+         * @brief 加载清单
+         * @return 是否加载成功；文件不存在、格式错误或任务键不同时返回 false 并从空清单开始
+         */
+        inline bool load()
+        {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::vector<char> data(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!file) {
+                return false;
+            }
+
+            Reader reader{ data.data(), data.data() + data.size() };
+            char magicBytes[4];
+            std::uint32_t version = 0;
+            std::uint32_t keyLength = 0;
+            std::uint64_t count = 0;
+            if (!reader.raw(magicBytes, 4) || std::memcmp(magicBytes, magic, 4) != 0
+                || !reader.pod(version) || version != formatVersion
+                || !reader.pod(keyLength) || !reader.matches(jobKey, keyLength)
+                || !reader.pod(count)) {
+                return false;
+            }
+
+            std::unordered_map<std::string, Entry> loaded;
+            loaded.reserve(static_cast<size_t>(std::min<std::uint64_t>(count, data.size() / 32 + 1)));
+            for (std::uint64_t i = 0; i < count; ++i) {
+                std::uint32_t pathLength = 0;
+                std::uint8_t result = 0;
+                std::uint8_t encodingLength = 0;
+                std::string key;
+                Entry entry;
+                if (!reader.pod(pathLength) || !reader.str(key, pathLength)
+                    || !reader.pod(entry.size) || !reader.pod(entry.mtime) || !reader.pod(entry.hash)
+                    || !reader.pod(result) || result > static_cast<std::uint8_t>(FileResult::Failed)
+                    || !reader.pod(encodingLength) || !reader.str(entry.encoding, encodingLength)) {
+                    return false;
+                }
+                entry.result = static_cast<FileResult>(result);
+                loaded.emplace(std::move(key), std::move(entry));
+            }
+            previous = std::move(loaded);
+            return true;
+        }
+
+        /**
+         * @brief 若文件自上次运行以来未变化，则沿用旧记录并返回 true
+         */
+        inline bool keepIfUnchanged(const std::string& filePath)
+        {
+            std::string key = keyOf(filePath);
+            auto it = previous.find(key);
+            if (it == previous.end() || it->second.result == FileResult::Failed) {
+                return false;
+            }
+            Entry stamp;
+            if (!stat(filePath, stamp) || stamp.size != it->second.size || stamp.mtime != it->second.mtime) {
+                return false;
+            }
+            if (verifyContent && (it->second.hash == 0 || hashFile(filePath) != it->second.hash)) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            current[key] = it->second;
+            return true;
+        }
+
+        /**
+         * @brief 记录文件本次的处理结果，大小与修改时间取处理后的状态
+         */
+        inline void record(const std::string& filePath, const FileOutcome& outcome)
+        {
+            Entry entry;
+            if (!stat(filePath, entry)) {
+                return;
+            }
+            entry.hash = outcome.hash;
+            entry.result = outcome.result;
+            entry.encoding = outcome.encoding.substr(0, 255);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            current[keyOf(filePath)] = std::move(entry);
+        }
+
+        /**
+         * @brief 写入本次运行的记录与未涉及文件的旧记录：先写临时文件，再重命名覆盖
+         *
+         * 旧记录对应的文件已不存在时丢弃该记录。
+         * @throw std::runtime_error 写入失败
+         */
+        inline void save()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& item : previous) {
+                std::error_code ec;
+                if (current.find(item.first) == current.end() && std::filesystem::is_regular_file(item.first, ec)) {
+                    current.emplace(item.first, item.second);
+                }
+            }
+
+            std::string data(magic, 4);
+            appendPod(data, formatVersion);
+            appendPod(data, static_cast<std::uint32_t>(jobKey.size()));
+            data += jobKey;
+            appendPod(data, static_cast<std::uint64_t>(current.size()));
+            for (const auto& item : current) {
+                appendPod(data, static_cast<std::uint32_t>(item.first.size()));
+                data += item.first;
+                appendPod(data, item.second.size);
+                appendPod(data, item.second.mtime);
+                appendPod(data, item.second.hash);
+                appendPod(data, static_cast<std::uint8_t>(item.second.result));
+                appendPod(data, static_cast<std::uint8_t>(item.second.encoding.size()));
+                data += item.second.encoding;
+            }
+
+            std::string tempPath = path + ".tmp";
+            {
+                std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+                if (!file.is_open()) {
+                    throw std::runtime_error("Failed to open manifest for writing: " + tempPath);
+                }
+                file.write(data.data(), static_cast<std::streamsize>(data.size()));
+                if (!file) {
+                    throw std::runtime_error("Failed to write manifest: " + tempPath);
+                }
+            }
+            std::filesystem::rename(tempPath, path);
+        }
+
+    private:
+        static constexpr char magic[5] = "ECMF";
+        static constexpr std::uint32_t formatVersion = 1;
+
+        struct Reader {
+            const char* pos;
+            const char* end;
+
+            inline bool raw(void* out, size_t size)
+            {
+                if (static_cast<size_t>(end - pos) < size) return false;
+                std::memcpy(out, pos, size);
+                pos += size;
+                return true;
+            }
+            template <typename T>
+            inline bool pod(T& out)
+            {
+                return raw(&out, sizeof(T));
+            }
+            inline bool str(std::string& out, size_t size)
+            {
+                if (static_cast<size_t>(end - pos) < size) return false;
+                out.assign(pos, size);
+                pos += size;
+                return true;
+            }
+            inline bool matches(const std::string& expected, size_t size)
+            {
+                std::string value;
+                return str(value, size) && value == expected;
+            }
+        };
+
+        template <typename T>
+        static inline void appendPod(std::string& out, const T& value)
+        {
+            out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        static inline std::string keyOf(const std::string& filePath)
+        {
+            std::error_code ec;
+            std::filesystem::path absolute = std::filesystem::absolute(filePath, ec);
+            return ec ? filePath : absolute.lexically_normal().string();
+        }
+
+        /**
+         * @brief 按块读取文件计算内容哈希，读取失败时返回 0
+         */
+        static inline std::uint64_t hashFile(const std::string& filePath)
+        {
+            std::ifstream file(filePath, std::ios::binary);
+            if (!file.is_open()) {
+                return 0;
+            }
+            ContentHasher hasher;
+            std::vector<char> buffer(1024 * 1024);
+            while (file) {
+                file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                hasher.update(buffer.data(), static_cast<size_t>(file.gcount()));
+            }
+            return file.bad() ? 0 : hasher.digest();
+        }
+
+        static inline bool stat(const std::string& filePath, Entry& entry)
+        {
+            std::error_code ec;
+            entry.size = std::filesystem::file_size(filePath, ec);
+            if (ec) return false;
+            auto mtime = std::filesystem::last_write_time(filePath, ec);
+            if (ec) return false;
+            entry.mtime = static_cast<std::int64_t>(mtime.time_since_epoch().count());
+            return true;
+        }
+
+        std::string path;                                   ///< 清单文件路径
+        std::string jobKey;                                 ///< 任务键（目标编码与源编码过滤器）
+        bool verifyContent;                                 ///< 是否比对内容哈希
+        std::unordered_map<std::string, Entry> previous;   ///< 上次运行的记录（只读）
+        std::unordered_map<std::string, Entry> current;    ///< 本次运行的记录
+        std::mutex mutex;                                   ///< 保护 current
+    };
+
+    /**
+     * @brief 一次 convert 调用内共享的只读状态
+     */
+    struct RunContext {
+        std::string toEncoding;                          ///< 目标编码（已映射）
+        FilterMatcher encodingFilter;                    ///< 预编译的源编码过滤器
+        std::unique_ptr<ConversionManifest> manifest;    ///< 增量转换清单，未启用时为空
+        std::shared_ptr<RunStatistics> statistics;       ///< 本次运行的统计
+        bool dryRun = false;                             ///< 演练模式，不写回文件
+    };
+
+    /**
+     * @brief 准备一次运行：映射目标编码、编译源编码过滤器、加载清单、重置统计
+     * @param dryRun 是否为演练模式（scan），演练模式不使用清单并记录逐文件信息
+     */
+    inline RunContext beginRun(const std::string& toEncoding, const std::string& sourceEncodingFilter, bool dryRun = false)
+    {
+        RunContext context;
+        context.toEncoding = mapTargetEncoding(toEncoding);
+        context.encodingFilter = compileFilter(sourceEncodingFilter, FilterMatcher::Mode::Whole);
+        context.dryRun = dryRun;
+        context.statistics = std::make_shared<RunStatistics>();
+        context.statistics->collectFiles = dryRun;
+        std::atomic_store(&lastStatistics, context.statistics);
+        if (!dryRun && !manifestPath.empty()) {
+            context.manifest = std::make_unique<ConversionManifest>(manifestPath, context.toEncoding + '\n' + sourceEncodingFilter,
+                                                                    manifestVerifyContent);
+            if (context.manifest->load()) {
+                writeLog(LogLevel::INFO, "Manifest loaded: ", manifestPath);
+            } else {
+                writeLog(LogLevel::INFO, "No usable manifest at ", manifestPath, ", starting fresh.");
+            }
+        }
+        return context;
+    }
+
+    /**
+     * @brief 结束一次运行：原子更新清单
+     */
+    inline void endRun(RunContext& context)
+    {
+        context.statistics->elapsedNs.store(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - context.statistics->start).count(),
+            std::memory_order_release);
+
+        if (!context.manifest) {
+            return;
+        }
+        try {
+            context.manifest->save();
+        }
+        catch (const std::exception& e) {
+            writeLog(LogLevel::ERROR, "Failed to save manifest: ", e.what());
+        }
+    }
+
+    /**
+     * @brief 处理单个文件：查询清单、转换并记录异常，保证单个文件失败不影响其他文件
+     * @return 处理结果
+     */
+    inline FileResult processFile(const std::string& filePath, const RunContext& context)
+    {
+        HEADONLY_PROFILE_SCOPE("EncodingConverter::processFile");
+        FileOutcome outcome;
+        if (context.manifest && context.manifest->keepIfUnchanged(filePath)) {
+            writeLog(LogLevel::INFO, filePath, " | unchanged since last run, skipped");
+            outcome.result = FileResult::Unchanged;
+            context.statistics->addFile(filePath, outcome);
+            return outcome.result;
+        }
+
+        try {
+            outcome = convertFile(filePath, context);
+        }
+        catch (const std::exception& e) {
+            writeLog(LogLevel::ERROR, "Error converting ", filePath, ": ", e.what());
+            outcome.result = FileResult::Failed;
+        }
+
+        if (context.manifest) {
+            context.manifest->record(filePath, outcome);
+        }
+        context.statistics->addFile(filePath, outcome);
+        return outcome.result;
+    }
+
+    /**
+     * @brief 只读文件视图
+     *
+     * POSIX 平台通过 mmap 零拷贝映射文件，其他平台退化为一次性读入缓冲区。
+     */
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path)
+        {
+#ifndef _WIN32
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                throw std::runtime_error("Failed to open file: " + path);
+            }
+            struct stat st;
+            if (::fstat(fd, &st) != 0) {
+                ::close(fd);
+                throw std::runtime_error("Failed to stat file: " + path);
+            }
+            length = static_cast<size_t>(st.st_size);
+            if (length > 0) {
+                void* addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr == MAP_FAILED) {
+                    ::close(fd);
+                    throw std::runtime_error("Failed to map file: " + path);
+                }
+                ::posix_madvise(addr, length, POSIX_MADV_SEQUENTIAL);
+                mapped = static_cast<const char*>(addr);
+            }
+            ::close(fd);
+#else
+            std::ifstream file(path, std::ios::binary);
+            if (!file.is_open()) {
+                throw std::runtime_error("Failed to open file: " + path);
+            }
+            buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            mapped = buffer.data();
+            length = buffer.size();
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile()
+        {
+#ifndef _WIN32
+            if (mapped != nullptr) {
+                ::munmap(const_cast<char*>(mapped), length);
+            }
+#endif
+        }
+
+        inline std::string_view view() const
+        {
+            return std::string_view(mapped, length);
+        }
+
+    private:
+        const char* mapped = nullptr;   ///< 文件内容起始地址
+        size_t length = 0;              ///< 文件长度
+#ifdef _WIN32
+        std::vector<char> buffer;       ///< 非 POSIX 平台的读入缓冲区
+#endif
+    };
+
+    /**
+     * @brief 增量 UTF-8 校验器，可分块输入，同时记录内容是否为纯 ASCII
+     *
+     * ASCII 段使用 SSE2/AVX2/NEON 批量跳过，多字节序列按 RFC 3629 逐个校验
+     * （拒绝超长编码、代理区与超出 U+10FFFF 的码点）。
+     */
+    class Utf8Validator {
+    public:
+        /**
+         * @brief 输入一块数据
+         * @return 目前为止内容是否仍为合法 UTF-8
+         */
+        inline bool feed(const char* data, size_t size)
+        {
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+            size_t i = 0;
+
+            // 先补全上一块末尾被截断的多字节序列
+            if (pendingLength > 0) {
+                size_t need = sequenceLength(pending[0]) - pendingLength;
+                size_t take = std::min(need, size);
+                std::copy(p, p + take, pending + pendingLength);
+                pendingLength += take;
+                i = take;
+                if (take < need) {
+                    return valid;
+                }
+                valid = validSequence(pending, pendingLength);
+                pendingLength = 0;
+            }
+
+            while (valid && i < size) {
+                i += asciiPrefixLength(p + i, size - i);
+                if (i >= size) {
+                    break;
+                }
+
+                ascii = false;
+                size_t len = sequenceLength(p[i]);
+                if (len == 0) {
+                    valid = false;
+                    break;
+                }
+                if (i + len > size) {
+                    pendingLength = size - i;
+                    std::copy(p + i, p + size, pending);
+                    break;
+                }
+                valid = validSequence(p + i, len);
+                i += len;
+            }
+            return valid;
+        }
+
+        /**
+         * @brief 结束输入
+         * @return 全部内容是否为合法 UTF-8
+         */
+        inline bool finish() const
+        {
+            return valid && pendingLength == 0;
+        }
+
+        /**
+         * @brief 已输入的内容是否全部为 7 位 ASCII
+         */
+        inline bool isAscii() const
+        {
+            return ascii && pendingLength == 0;
+        }
+
+        /**
+         * @brief 计算从 p 开始的连续 ASCII 字节数
+         */
+        static inline size_t asciiPrefixLength(const unsigned char* p, size_t size)
+        {
+            size_t i = 0;
+#if defined(ENCODINGCONVERTER_X86_SIMD)
+#if defined(__AVX2__)
+            for (; i + 32 <= size; i += 32) {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+                if (_mm256_movemask_epi8(block) != 0) break;
+            }
+#endif
+            for (; i + 16 <= size; i += 16) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+                if (_mm_movemask_epi8(block) != 0) break;
+            }
+#elif defined(ENCODINGCONVERTER_NEON_SIMD)
+            for (; i + 16 <= size; i += 16) {
+                if (vmaxvq_u8(vld1q_u8(p + i)) >= 0x80) break;
+            }
+#endif
+            while (i < size && p[i] < 0x80) {
+                ++i;
+            }
+            return i;
+        }
+
+    private:
+        static inline size_t sequenceLength(unsigned char lead)
+        {
+            if (lead >= 0xC2 && lead <= 0xDF) return 2;
+            if (lead >= 0xE0 && lead <= 0xEF) return 3;
+            if (lead >= 0xF0 && lead <= 0xF4) return 4;
+            return 0;
+        }
+
+        static inline bool validSequence(const unsigned char* p, size_t len)
+        {
+            unsigned char lo = 0x80, hi = 0xBF;
+            switch (p[0]) {
+            case 0xE0: lo = 0xA0; break;
+            case 0xED: hi = 0x9F; break;
+            case 0xF0: lo = 0x90; break;
+            case 0xF4: hi = 0x8F; break;
+            default: break;
+            }
+            if (p[1] < lo || p[1] > hi) return false;
+            for (size_t k = 2; k < len; ++k) {
+                if (p[k] < 0x80 || p[k] > 0xBF) return false;
+            }
+            return true;
+        }
+
+        bool valid = true;                 ///< 目前为止是否合法
+        bool ascii = true;                 ///< 目前为止是否为纯 ASCII
+        unsigned char pending[4] = {};     ///< 被块边界截断的多字节序列
+        size_t pendingLength = 0;          ///< 截断序列已收到的字节数
+    };
+
+    /**
+     * @brief 判断无需转换即可跳过文件
+     * @param validator 已输入完整文件内容的校验器
+     * @param toEncoding 目标编码（已映射）
      */
-    EncodingConverter() = default;
+    inline bool alreadyInTarget(const Utf8Validator& validator, const std::string& toEncoding) const
+    {
+        if (!validator.finish()) {
+            return false;
+        }
+        if (toEncoding == "UTF-8") {
+            return true;
+        }
+        // ASCII 字节在这些编码中表示相同字符
+        static const std::unordered_set<std::string> asciiCompatible = {
+            "ASCII", "GBK", "GB18030", "Big5", "windows-1252", "ISO-8859-1"
+        };
+        return validator.isAscii() && asciiCompatible.count(toEncoding) > 0;
+    }
 
     /**
-     * @brief 将指定路径（文件或目录）中的文件转换为指定编码（异步多线程处理）
-     * @param path 要处理的文件或目录路径
-     * @param toEncoding 目标编码
-     * @param sourceEncodingFilter 源编码过滤器（正则表达式），为空则不过滤
-     * @param fileFilter 文件过滤规则（正则表达式），为空则不过滤
+     * @brief 分块读取大文件，判断能否跳过转换，遇到非法 UTF-8 即停止
      */
-    inline void convert(
-        const std::string& path,
-        const std::string& toEncoding,
-        const std::string& sourceEncodingFilter = "",
-        const std::string& fileFilter = ""
-        ) {
-        namespace fs = std::filesystem;
-        fs::path inputPath(path);
-        std::vector<std::future<void>> futures;
-
-        std::string mappedToEncoding = mapEncodingName(toEncoding);
-        if (mappedToEncoding.empty()) {
-            logMessage(LogLevel::ERROR, "Unsupported target encoding: " + toEncoding);
-            throw std::runtime_error("Unsupported target encoding: " + toEncoding);
-        } else {
-            logMessage(LogLevel::INFO, "Target Encoding Mapped: " + mappedToEncoding);
+    inline bool streamAlreadyInTarget(const std::string& filePath, const std::string& toEncoding, ContentHasher* hasher)
+    {
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file.is_open()) {
+            writeLog(LogLevel::ERROR, "Failed to open file: ", filePath);
+            throw std::runtime_error("Failed to open file: " + filePath);
         }
 
-        if (fs::is_directory(inputPath)) {
-            logMessage(LogLevel::INFO, "Processing directory: " + inputPath.string());
-            for (const auto& entry : fs::recursive_directory_iterator(inputPath)) {
-                if (entry.is_regular_file()) {
-                    std::string fileName = entry.path().filename().string();
-                    if (shouldProcessFile(fileName, fileFilter)) {
-                        futures.emplace_back(std::async(std::launch::async, [this, entry, mappedToEncoding, sourceEncodingFilter]() {
-                            try {
-                                convertFile(entry.path().string(), mappedToEncoding, sourceEncodingFilter);
-                            }
-                            catch (const std::exception& e) {
-                                logMessage(LogLevel::ERROR, "Error converting " + entry.path().string() + ": " + e.what());
-                            }
-                        }));
-                    }
-                } else {
-                    logMessage(LogLevel::WARN, "Skipping non-regular file: " + entry.path().string());
-                }
+        Utf8Validator validator;
+        std::vector<char> chunk(streamChunkSize);
+        while (file) {
+            file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            std::streamsize count = file.gcount();
+            if (count <= 0) {
+                break;
             }
-        } else if (fs::is_regular_file(inputPath)) {
-            std::string fileName = inputPath.filename().string();
-            if (shouldProcessFile(fileName, fileFilter)) {
-                logMessage(LogLevel::INFO, "Processing single file: " + inputPath.string());
+            if (!validator.feed(chunk.data(), static_cast<size_t>(count))) {
+                return false;
+            }
+            if (!validator.isAscii() && toEncoding != "UTF-8") {
+                return false;
+            }
+            if (hasher) {
+                hasher->update(chunk.data(), static_cast<size_t>(count));
+            }
+        }
+        return alreadyInTarget(validator, toEncoding);
+    }
+
+    inline FileOutcome convertFile(const std::string& filePath, const RunContext& context)
+    {
+        const std::string& toEncoding = context.toEncoding;
+        const bool wantHash = context.manifest && context.manifest->verifiesContent();
+        RunStatistics& stats = *context.statistics;
+        FileOutcome outcome;
+
+        std::uintmax_t fileSize = std::filesystem::file_size(filePath);
+        if (fileSize >= streamingThreshold || fileSize > maxInMemorySize) {
+            return convertFileStreaming(filePath, context);
+        }
+        outcome.bytes = fileSize;
+
+        ConverterCache& cache = threadConverters();
+        cache.trimOutput();
+        std::string& convertedContent = cache.output;
+        {
+            std::unique_ptr<MappedFile> file;
+            bool skip = false;
+            {
+                PhaseTimer timer(stats, stats.readNs);
+                HEADONLY_PROFILE_SCOPE("EncodingConverter::read");
                 try {
-                    convertFile(inputPath.string(), mappedToEncoding, sourceEncodingFilter);
+                    file = std::make_unique<MappedFile>(filePath);
                 }
                 catch (const std::exception& e) {
-                    logMessage(LogLevel::ERROR, "Error converting " + inputPath.string() + ": " + e.what());
+                    writeLog(LogLevel::ERROR, e.what());
+                    throw;
+                }
+                if (fastSkip) {
+                    Utf8Validator validator;
+                    skip = validator.feed(file->view().data(), file->view().size()) && alreadyInTarget(validator, toEncoding);
                 }
-            } else {
-                logMessage(LogLevel::WARN, "File does not match filter and will be skipped: " + inputPath.string());
             }
-        } else {
-            logMessage(LogLevel::ERROR, "Invalid path: " + path);
-            throw std::runtime_error("Invalid path: " + path);
-        }
+            std::string_view fileContent = file->view();
+
+            if (skip) {
+                writeLog(LogLevel::INFO, filePath, " | already ", toEncoding, ", skipped");
+                outcome.result = FileResult::AlreadyTarget;
+                outcome.encoding = toEncoding;
+                outcome.confidence = 1.0;
+                outcome.hash = wantHash ? contentHash(fileContent) : 0;
+                return outcome;
+            }
+
+            std::string detectedEncoding;
+            {
+                PhaseTimer timer(stats, stats.detectNs);
+                HEADONLY_PROFILE_SCOPE("EncodingConverter::detect");
+                detectedEncoding = detectEncoding(fileContent, context.encodingFilter, &outcome.confidence);
+            }
+            outcome.result = FileResult::Skipped;
+            outcome.encoding = detectedEncoding;
+            outcome.hash = wantHash ? contentHash(fileContent) : 0;
+
+            if (detectedEncoding == "UNKNOWN" || detectedEncoding == "MISMATCH") {
+                writeLog(LogLevel::WARN, "Skipping file due to encoding issues: ", filePath);
+                return outcome;
+            }
+
+            outcome.encoding = mapEncodingName(detectedEncoding);
+            if (outcome.encoding.empty()) {
+                writeLog(LogLevel::WARN, "Unsupported detected encoding '", detectedEncoding, "' for file: ", filePath);
+                return outcome;
+            }
 
-        for (auto& future : futures) {
             try {
-                future.get();
+                PhaseTimer timer(stats, stats.convertNs);
+                HEADONLY_PROFILE_SCOPE("EncodingConverter::convert");
+                convertEncoding(fileContent, outcome.encoding, toEncoding, convertedContent);
             }
             catch (const std::exception& e) {
-                logMessage(LogLevel::ERROR, "Asynchronous task failed: " + std::string(e.what()));
+                writeLog(LogLevel::ERROR, "Conversion failed for file: ", filePath, " | Error: ", e.what());
+                throw;
             }
+        }   // 写回前释放映射
+
+        if (context.dryRun) {
+            writeLog(LogLevel::INFO, filePath, " | ", outcome.encoding, " -> ", toEncoding, " (dry run)");
+            outcome.result = FileResult::Converted;
+            return outcome;
         }
 
-        // logMessage(LogLevel::INFO, "Conversion process completed.");
+        {
+            PhaseTimer timer(stats, stats.writeNs);
+            HEADONLY_PROFILE_SCOPE("EncodingConverter::write");
+            std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
+            if (!outputFile.is_open()) {
+                writeLog(LogLevel::ERROR, "Failed to open file for writing: ", filePath);
+                throw std::runtime_error("Failed to open file for writing: " + filePath);
+            }
+            outputFile.write(convertedContent.data(), convertedContent.size());
+            outputFile.close();
+        }
+
+        writeLog(LogLevel::INFO, filePath, " | ", outcome.encoding, " -> ", toEncoding);
+        outcome.result = FileResult::Converted;
+        outcome.hash = wantHash ? contentHash(convertedContent) : 0;
+        return outcome;
     }
 
     /**
-     * @brief 以单线程方式处理指定路径文件的转换（不使用异步）
-     * @param path 路径（文件或目录）
-     * @param toEncoding 目标编码
-     * @param sourceEncodingFilter 源编码过滤器（可选）
-     * @param fileFilter 文件过滤（可选）
+     * @brief 流式转换大文件：分块检测编码，再分块转换写入临时文件，最后原子替换原文件
      */
-    inline void convert_single(
-        const std::string& path,
-        const std::string& toEncoding,
-        const std::string& sourceEncodingFilter = "",
-        const std::string& fileFilter = ""
-        ) {
-        namespace fs = std::filesystem;
-        fs::path inputPath(path);
+    inline FileOutcome convertFileStreaming(const std::string& filePath, const RunContext& context)
+    {
+        const std::string& toEncoding = context.toEncoding;
+        const bool wantHash = context.manifest && context.manifest->verifiesContent();
+        RunStatistics& stats = *context.statistics;
+        FileOutcome outcome;
+        outcome.bytes = std::filesystem::file_size(filePath);
 
-        std::string mappedToEncoding = mapEncodingName(toEncoding);
-        if (mappedToEncoding.empty()) {
-            logMessage(LogLevel::ERROR, "Unsupported target encoding: " + toEncoding);
-            throw std::runtime_error("Unsupported target encoding: " + toEncoding);
-        } else {
-            logMessage(LogLevel::INFO, "Target Encoding Mapped: " + mappedToEncoding);
+        ContentHasher hasher;
+        bool skip = false;
+        if (fastSkip) {
+            PhaseTimer timer(stats, stats.readNs);
+            HEADONLY_PROFILE_SCOPE("EncodingConverter::read");
+            skip = streamAlreadyInTarget(filePath, toEncoding, wantHash ? &hasher : nullptr);
+        }
+        if (skip) {
+            writeLog(LogLevel::INFO, filePath, " | already ", toEncoding, ", skipped");
+            outcome.result = FileResult::AlreadyTarget;
+            outcome.encoding = toEncoding;
+            outcome.confidence = 1.0;
+            outcome.hash = wantHash ? hasher.digest() : 0;
+            return outcome;
         }
 
-        if (fs::is_directory(inputPath)) {
-            logMessage(LogLevel::INFO, "Processing directory: " + inputPath.string());
-            for (const auto& entry : fs::recursive_directory_iterator(inputPath)) {
-                if (entry.is_regular_file()) {
-                    std::string fileName = entry.path().filename().string();
-                    if (shouldProcessFile(fileName, fileFilter)) {
-                        try {
-                            convertFile(entry.path().string(), mappedToEncoding, sourceEncodingFilter);
-                        }
-                        catch (const std::exception& e) {
-                            logMessage(LogLevel::ERROR, "Error converting " + entry.path().string() + ": " + e.what());
-                        }
-                    }
-                } else {
-                    logMessage(LogLevel::WARN, "Skipping non-regular file: " + entry.path().string());
-                }
+        std::string detectedEncoding;
+        {
+            PhaseTimer timer(stats, stats.detectNs);
+            HEADONLY_PROFILE_SCOPE("EncodingConverter::detect");
+            detectedEncoding = detectEncodingStream(filePath, context.encodingFilter, &outcome.confidence);
+        }
+        outcome.result = FileResult::Skipped;
+        outcome.encoding = detectedEncoding;
+
+        if (detectedEncoding == "UNKNOWN" || detectedEncoding == "MISMATCH") {
+            writeLog(LogLevel::WARN, "Skipping file due to encoding issues: ", filePath);
+            return outcome;
+        }
+
+        outcome.encoding = mapEncodingName(detectedEncoding);
+        if (outcome.encoding.empty()) {
+            writeLog(LogLevel::WARN, "Unsupported detected encoding '", detectedEncoding, "' for file: ", filePath);
+            return outcome;
+        }
+
+        std::string tempPath = tempPathFor(filePath);
+        ContentHasher outputHasher;
+        try {
+            if (context.dryRun) {
+                PhaseTimer timer(stats, stats.convertNs);
+                HEADONLY_PROFILE_SCOPE("EncodingConverter::convert");
+                convertStream(filePath, "", outcome.encoding, toEncoding, nullptr);
+                writeLog(LogLevel::INFO, filePath, " | ", outcome.encoding, " -> ", toEncoding, " (dry run)");
+                outcome.result = FileResult::Converted;
+                return outcome;
             }
-        } else if (fs::is_regular_file(inputPath)) {
-            std::string fileName = inputPath.filename().string();
-            if (shouldProcessFile(fileName, fileFilter)) {
-                logMessage(LogLevel::INFO, "Processing single file: " + inputPath.string());
-                try {
-                    convertFile(inputPath.string(), mappedToEncoding, sourceEncodingFilter);
+            {
+                PhaseTimer timer(stats, stats.convertNs);
+                HEADONLY_PROFILE_SCOPE("EncodingConverter::convert");
+                convertStream(filePath, tempPath, outcome.encoding, toEncoding, wantHash ? &outputHasher : nullptr);
+            }
+            PhaseTimer timer(stats, stats.writeNs);
+            HEADONLY_PROFILE_SCOPE("EncodingConverter::write");
+            std::filesystem::permissions(tempPath, std::filesystem::status(filePath).permissions());
+            std::filesystem::rename(tempPath, filePath);
+        }
+        catch (const std::exception& e) {
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            writeLog(LogLevel::ERROR, "Conversion failed for file: ", filePath, " | Error: ", e.what());
+            throw;
+        }
+
+        writeLog(LogLevel::INFO, filePath, " | ", outcome.encoding, " -> ", toEncoding);
+        outcome.result = FileResult::Converted;
+        outcome.hash = wantHash ? outputHasher.digest() : 0;
+        return outcome;
+    }
+
+    /**
+     * @brief 使用 ucnv_convertEx 以固定大小的输入/输出块转换文件
+     * @param inputPath 源文件
+     * @param outputPath 输出文件，为空时只转换不写出（演练模式）
+     * @param fromEncoding 源编码（已映射）
+     * @param toEncoding 目标编码（已映射）
+     * @param hasher 输出内容哈希，可为空
+     */
+    inline void convertStream(const std::string& inputPath, const std::string& outputPath, const std::string& fromEncoding, const std::string& toEncoding, ContentHasher* hasher)
+    {
+        std::ifstream input(inputPath, std::ios::binary);
+        if (!input.is_open()) {
+            writeLog(LogLevel::ERROR, "Failed to open file: ", inputPath);
+            throw std::runtime_error("Failed to open file: " + inputPath);
+        }
+        std::ofstream output;
+        if (!outputPath.empty()) {
+            output.open(outputPath, std::ios::binary | std::ios::trunc);
+            if (!output.is_open()) {
+                writeLog(LogLevel::ERROR, "Failed to open file for writing: ", outputPath);
+                throw std::runtime_error("Failed to open file for writing: " + outputPath);
+            }
+        }
+
+        std::pair<UConverter*, UConverter*> converters = openConverters(fromEncoding, toEncoding);
+        UErrorCode status = U_ZERO_ERROR;
+
+        std::vector<char> inBuffer(streamChunkSize);
+        std::vector<char> outBuffer(streamChunkSize * 2);
+        std::vector<UChar> pivot(streamChunkSize / 2);
+        UChar* pivotSource = pivot.data();
+        UChar* pivotTarget = pivot.data();
+        bool reset = true;
+
+        while (true) {
+            input.read(inBuffer.data(), static_cast<std::streamsize>(inBuffer.size()));
+            std::streamsize count = input.gcount();
+            bool flush = !input;
+            const char* src = inBuffer.data();
+            const char* srcLimit = src + std::max<std::streamsize>(count, 0);
+
+            do {
+                char* dst = outBuffer.data();
+                status = U_ZERO_ERROR;
+                ucnv_convertEx(converters.second, converters.first,
+                               &dst, outBuffer.data() + outBuffer.size(),
+                               &src, srcLimit,
+                               pivot.data(), &pivotSource, &pivotTarget, pivot.data() + pivot.size(),
+                               reset, flush, &status);
+                reset = false;
+                if (output.is_open()) {
+                    output.write(outBuffer.data(), dst - outBuffer.data());
                 }
-                catch (const std::exception& e) {
-                    logMessage(LogLevel::ERROR, "Error converting " + inputPath.string() + ": " + e.what());
+                if (hasher) {
+                    hasher->update(outBuffer.data(), static_cast<size_t>(dst - outBuffer.data()));
                 }
-            } else {
-                logMessage(LogLevel::WARN, "File does not match filter and will be skipped: " + inputPath.string());
+            } while (status == U_BUFFER_OVERFLOW_ERROR);
+
+            if (U_FAILURE(status)) {
+                writeLog(LogLevel::ERROR, "ICU conversion failed: ", u_errorName(status));
+                throw std::runtime_error("ICU conversion failed: " + std::string(u_errorName(status)));
+            }
+            if (!output) {
+                throw std::runtime_error("Failed to write file: " + outputPath);
+            }
+            if (flush) {
+                break;
             }
-        } else {
-            logMessage(LogLevel::ERROR, "Invalid path: " + path);
-            throw std::runtime_error("Invalid path: " + path);
         }
-
-        // logMessage(LogLevel::INFO, "Conversion process completed.");
     }
 
-protected:
     /**
-     * @brief 可重写的日志函数，子类可重写此函数实现自定义日志输出
-     * @param level 日志级别
-     * @param message 日志信息
+     * @brief 检测内存中数据的编码，按检测选项分块、采样送入 uchardet
      */
-    virtual void logMessage(LogLevel level, const std::string& message) {
-        std::string prefix;
-        switch (level) {
-        case LogLevel::INFO:
-            prefix = "[INFO] ";
-            break;
-        case LogLevel::WARN:
-            prefix = "[WARN] ";
-            break;
-        case LogLevel::ERROR:
-            prefix = "[ERROR] ";
-            break;
+    inline std::string detectEncoding(std::string_view data, const FilterMatcher& encodingFilter, double* confidence = nullptr)
+    {
+        uchardet_t ud = threadDetector();
+        DetectionProgress progress;
+
+        for (const auto& range : detectionRanges(data.size())) {
+            const char* begin = data.data() + range.first;
+            const char* end = begin + range.second;
+            bool keepFeeding = true;
+            while (begin < end && keepFeeding) {
+                size_t count = std::min<size_t>(detectionOptions.chunkSize, end - begin);
+                keepFeeding = feedDetector(ud, begin, count, progress);
+                begin += count;
+            }
+            if (!keepFeeding) {
+                break;
+            }
         }
 
-        std::cerr << prefix << message << std::endl;
+        return applyEncodingFilter(finishDetection(ud, confidence), encodingFilter);
     }
 
-private:
-    inline void convertFile(const std::string& filePath, const std::string& toEncoding, const std::string& sourceEncodingFilter)
+    /**
+     * @brief 检测文件的编码，只读取检测选项要求的区间，内存占用为一个块的大小
+     */
+    inline std::string detectEncodingStream(const std::string& filePath, const FilterMatcher& encodingFilter, double* confidence = nullptr)
     {
         std::ifstream file(filePath, std::ios::binary);
         if (!file.is_open()) {
-            logMessage(LogLevel::ERROR, "Failed to open file: " + filePath);
+            writeLog(LogLevel::ERROR, "Failed to open file: ", filePath);
             throw std::runtime_error("Failed to open file: " + filePath);
         }
 
-        std::vector<char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-        file.close();
+        uchardet_t ud = threadDetector();
+        DetectionProgress progress;
+        std::vector<char> chunk(detectionOptions.chunkSize);
 
-        std::string fileContent(buffer.begin(), buffer.end());
-        std::string detectedEncoding = detectEncoding(fileContent, sourceEncodingFilter);
+        for (const auto& range : detectionRanges(std::filesystem::file_size(filePath))) {
+            file.clear();
+            file.seekg(static_cast<std::streamoff>(range.first));
+            std::uintmax_t remaining = range.second;
+            bool keepFeeding = true;
+            while (remaining > 0 && keepFeeding && file) {
+                file.read(chunk.data(), static_cast<std::streamsize>(std::min<std::uintmax_t>(chunk.size(), remaining)));
+                std::streamsize count = file.gcount();
+                if (count <= 0) {
+                    break;
+                }
+                remaining -= static_cast<std::uintmax_t>(count);
+                keepFeeding = feedDetector(ud, chunk.data(), static_cast<size_t>(count), progress);
+            }
+            if (!keepFeeding) {
+                break;
+            }
+        }
 
-        if (detectedEncoding == "UNKNOWN" || detectedEncoding == "MISMATCH") {
-            logMessage(LogLevel::WARN, "Skipping file due to encoding issues: " + filePath);
-            return;
+        return applyEncodingFilter(finishDetection(ud, confidence), encodingFilter);
+    }
+
+    /**
+     * @brief 单次检测的进度，用于判断是否可以提前结束
+     */
+    struct DetectionProgress {
+        bool sawNonAscii = false;              ///< 是否已出现非 ASCII 字节
+        std::uintmax_t bytesAfterNonAscii = 0; ///< 首个非 ASCII 字节之后送入的字节数
+    };
+
+    /**
+     * @brief 获取当前线程复用的 uchardet 句柄（已 reset）
+     *
+     * 每个工作线程只创建一次检测器，之后每个文件通过 uchardet_reset 复用。
+     */
+    inline uchardet_t threadDetector()
+    {
+        struct DetectorHolder {
+            uchardet_t handle = uchardet_new();
+            ~DetectorHolder() {
+                if (handle) uchardet_delete(handle);
+            }
+        };
+        thread_local DetectorHolder holder;
+
+        if (holder.handle == nullptr) {
+            writeLog(LogLevel::ERROR, "Failed to initialize uchardet.");
+            throw std::runtime_error("Failed to initialize uchardet.");
         }
+        uchardet_reset(holder.handle);
+        return holder.handle;
+    }
 
-        std::string mappedDetectedEncoding = mapEncodingName(detectedEncoding);
-        if (mappedDetectedEncoding.empty()) {
-            logMessage(LogLevel::WARN, "Unsupported detected encoding '" + detectedEncoding + "' for file: " + filePath);
-            return;
+    /**
+     * @brief 计算需要送入检测器的区间（偏移，长度）
+     *
+     * 未启用采样或文件不大于采样总量时返回整个文件，否则返回头部、中部、尾部三个区间。
+     */
+    inline std::vector<std::pair<std::uintmax_t, std::uintmax_t>> detectionRanges(std::uintmax_t size) const
+    {
+        const DetectionOptions& opt = detectionOptions;
+        std::uintmax_t sampleTotal = opt.headBytes + opt.middleBytes + opt.tailBytes;
+        if (sampleTotal == 0 || size <= sampleTotal) {
+            return { { 0, size } };
         }
 
-        std::string convertedContent;
-        try {
-            convertEncoding(fileContent, mappedDetectedEncoding, toEncoding, convertedContent);
+        std::vector<std::pair<std::uintmax_t, std::uintmax_t>> ranges;
+        if (opt.headBytes > 0) {
+            ranges.emplace_back(0, opt.headBytes);
         }
-        catch (const std::exception& e) {
-            logMessage(LogLevel::ERROR, "Conversion failed for file: " + filePath + " | Error: " + e.what());
-            throw;
+        if (opt.middleBytes > 0) {
+            ranges.emplace_back((size - opt.middleBytes) / 2, opt.middleBytes);
         }
-
-        std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
-        if (!outputFile.is_open()) {
-            logMessage(LogLevel::ERROR, "Failed to open file for writing: " + filePath);
-            throw std::runtime_error("Failed to open file for writing: " + filePath);
+        if (opt.tailBytes > 0) {
+            ranges.emplace_back(size - opt.tailBytes, opt.tailBytes);
         }
-        outputFile.write(convertedContent.data(), convertedContent.size());
-        outputFile.close();
-
-        logMessage(LogLevel::INFO, filePath + " | " + mappedDetectedEncoding + " -> " + toEncoding);
+        return ranges;
     }
 
-    inline std::string detectEncoding(const std::string& data, const std::string& encodingFilter = "")
+    /**
+     * @brief 向检测器送入一块数据
+     * @return 是否需要继续送入数据；达到置信字节数后返回 false
+     */
+    inline bool feedDetector(uchardet_t ud, const char* data, size_t size, DetectionProgress& progress)
     {
-        uchardet_t ud = uchardet_new();
-        if (ud == nullptr) {
-            logMessage(LogLevel::ERROR, "Failed to initialize uchardet.");
-            throw std::runtime_error("Failed to initialize uchardet.");
+        if (uchardet_handle_data(ud, data, size) != 0) {
+            writeLog(LogLevel::ERROR, "Failed to handle data with uchardet.");
+            throw std::runtime_error("Failed to handle data with uchardet.");
         }
 
-        if (uchardet_handle_data(ud, data.data(), data.size()) != 0) {
-            logMessage(LogLevel::ERROR, "Failed to handle data with uchardet.");
-            uchardet_delete(ud);
-            throw std::runtime_error("Failed to handle data with uchardet.");
+        if (detectionOptions.confidenceBytes == 0) {
+            return true;
+        }
+
+        // 纯 ASCII 内容不能区分编码，从首个非 ASCII 字节开始累计
+        if (!progress.sawNonAscii) {
+            const char* firstHigh = std::find_if(data, data + size, [](char c) {
+                return static_cast<unsigned char>(c) >= 0x80;
+            });
+            if (firstHigh == data + size) {
+                return true;
+            }
+            progress.sawNonAscii = true;
+            progress.bytesAfterNonAscii = static_cast<std::uintmax_t>(data + size - firstHigh);
+        } else {
+            progress.bytesAfterNonAscii += size;
         }
+        return progress.bytesAfterNonAscii < detectionOptions.confidenceBytes;
+    }
 
+    /**
+     * @brief 结束检测并返回结果，无法识别时返回 "UNKNOWN"
+     * @param confidence 置信度输出，可为空。uchardet 0.0.8 起才提供置信度，
+     *        需定义 ENCODINGCONVERTER_UCHARDET_CONFIDENCE 启用，否则输出 -1
+     */
+    inline std::string finishDetection(uchardet_t ud, double* confidence = nullptr)
+    {
         uchardet_data_end(ud);
         const char* detectedCharset = uchardet_get_charset(ud);
-        std::string result = detectedCharset ? detectedCharset : "UNKNOWN";
-        uchardet_delete(ud);
+        if (confidence) {
+#ifdef ENCODINGCONVERTER_UCHARDET_CONFIDENCE
+            *confidence = uchardet_get_n_candidates(ud) > 0 ? uchardet_get_confidence(ud, 0) : 0.0;
+#else
+            *confidence = -1;
+#endif
+        }
+        return (detectedCharset && *detectedCharset) ? detectedCharset : "UNKNOWN";
+    }
 
-        if (!encodingFilter.empty() && result != "UNKNOWN") {
-            try {
-                std::regex re("^(" + encodingFilter + ")$", std::regex_constants::ECMAScript | std::regex_constants::icase);
-                if (!std::regex_match(result, re)) {
-                    logMessage(LogLevel::WARN, "Detected encoding '" + result + "' does not match filter: '" + encodingFilter + "'.");
-                    return "MISMATCH";
+    /**
+     * @brief 用源编码过滤器检查检测结果，不匹配时返回 "MISMATCH"
+     */
+    inline std::string applyEncodingFilter(const std::string& result, const FilterMatcher& encodingFilter)
+    {
+        if (!encodingFilter.empty() && result != "UNKNOWN" && !encodingFilter.matches(result)) {
+            writeLog(LogLevel::WARN, "Detected encoding '", result, "' does not match filter: '", encodingFilter.str(), "'.");
+            return "MISMATCH";
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief 当前线程复用的 ICU 转换器与缓冲区
+     *
+     * 转换器按映射后的编码名称缓存，每个文件开始时 reset 而不是重新打开；
+     * 源与目标各有一组转换器，源编码与目标编码同名时两侧也不共用同一个转换器的状态。
+     * 输出缓冲区在文件之间复用，下一个文件开始时若超过 maxRetainedBuffer 则释放。
+     */
+    struct ConverterCache {
+        struct Closer {
+            void operator()(UConverter* converter) const { ucnv_close(converter); }
+        };
+
+        using ConverterMap = std::unordered_map<std::string, std::unique_ptr<UConverter, Closer>>;
+
+        ConverterMap sources;                                                            ///< 已打开的源编码转换器
+        ConverterMap targets;                                                            ///< 已打开的目标编码转换器
+        std::vector<UChar> pivot = std::vector<UChar>(16 * 1024);                       ///< ucnv_convertEx 的中转缓冲
+        std::string output;                                                              ///< 复用的输出缓冲区
+
+        static constexpr size_t maxRetainedBuffer = 8 * 1024 * 1024;                     ///< 文件之间保留的最大输出缓冲
+
+        /**
+         * @brief 获取（必要时打开）指定编码的转换器，并重置其状态
+         * @param converters 源或目标转换器组
+         * @return 转换器；打开失败时返回 nullptr，status 为 ICU 错误码
+         */
+        static inline UConverter* get(ConverterMap& converters, const std::string& name, UErrorCode& status)
+        {
+            auto it = converters.find(name);
+            if (it == converters.end()) {
+                UConverter* converter = ucnv_open(name.c_str(), &status);
+                if (U_FAILURE(status)) {
+                    return nullptr;
                 }
+                it = converters.emplace(name, std::unique_ptr<UConverter, Closer>(converter)).first;
             }
-            catch (const std::regex_error& e) {
-                logMessage(LogLevel::ERROR, "Invalid regex filter: " + encodingFilter + " | Error: " + e.what());
-                throw std::runtime_error("Invalid regex filter: " + encodingFilter);
+            ucnv_reset(it->second.get());
+            return it->second.get();
+        }
+
+        /**
+         * @brief 释放过大的输出缓冲区，避免处理过一个大文件后每个线程长期占用内存
+         */
+        inline void trimOutput()
+        {
+            if (output.capacity() > maxRetainedBuffer) {
+                std::string().swap(output);
+            } else {
+                output.clear();
             }
         }
+    };
 
-        return result;
+    static inline ConverterCache& threadConverters()
+    {
+        thread_local ConverterCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief 打开（或从缓存取出）一对转换器，失败时记录日志并抛出异常
+     */
+    inline std::pair<UConverter*, UConverter*> openConverters(const std::string& fromEncoding, const std::string& toEncoding)
+    {
+        ConverterCache& cache = threadConverters();
+        UErrorCode status = U_ZERO_ERROR;
+        UConverter* source = ConverterCache::get(cache.sources, fromEncoding, status);
+        UConverter* target = source ? ConverterCache::get(cache.targets, toEncoding, status) : nullptr;
+        if (U_FAILURE(status)) {
+            writeLog(LogLevel::ERROR, "ICU converter open failed: ", u_errorName(status));
+            throw std::runtime_error("ICU converter open failed: " + std::string(u_errorName(status)));
+        }
+        return { source, target };
     }
 
-    inline void convertEncoding(const std::string& input, const std::string& fromEncoding, const std::string& toEncoding, std::string& output)
+    inline void convertEncoding(std::string_view input, const std::string& fromEncoding, const std::string& toEncoding, std::string& output)
     {
+        std::pair<UConverter*, UConverter*> converters = openConverters(fromEncoding, toEncoding);
+        std::vector<UChar>& pivot = threadConverters().pivot;
+        UChar* pivotSource = pivot.data();
+        UChar* pivotTarget = pivot.data();
+
+        const char* src = input.data();
+        const char* srcLimit = src + input.size();
+        // 按输入大小分配：保留的容量已避免重新分配，不要按容量 resize，否则每个小文件都要清零整块缓冲区
+        output.resize(input.size() * 2 + 64);
+        size_t written = 0;
+        bool reset = true;
+
         UErrorCode status = U_ZERO_ERROR;
-        int32_t targetCapacity = static_cast<int32_t>(input.size()) * 4 + 1;
-        std::vector<char> targetBuffer(targetCapacity);
-
-        int32_t convertedSize = ucnv_convert(
-            toEncoding.c_str(),
-            fromEncoding.c_str(),
-            targetBuffer.data(),
-            targetCapacity,
-            input.c_str(),
-            static_cast<int32_t>(input.size()),
-            &status
-            );
+        while (true) {
+            char* dst = &output[0] + written;
+            status = U_ZERO_ERROR;
+            ucnv_convertEx(converters.second, converters.first,
+                           &dst, output.data() + output.size(),
+                           &src, srcLimit,
+                           pivot.data(), &pivotSource, &pivotTarget, pivot.data() + pivot.size(),
+                           reset, true, &status);
+            reset = false;
+            written = static_cast<size_t>(dst - output.data());
+            if (status != U_BUFFER_OVERFLOW_ERROR) {
+                break;
+            }
+            output.resize(output.size() * 2);
+        }
 
         if (U_FAILURE(status)) {
-            logMessage(LogLevel::ERROR, "ICU conversion failed: " + std::string(u_errorName(status)));
+            writeLog(LogLevel::ERROR, "ICU conversion failed: ", u_errorName(status));
             throw std::runtime_error("ICU conversion failed: " + std::string(u_errorName(status)));
         }
 
-        output.assign(targetBuffer.data(), convertedSize);
+        output.resize(written);
     }
 
-    inline bool shouldProcessFile(const std::string& fileName, const std::string& filter)
+    inline bool shouldProcessFile(const std::string& fileName, const FilterMatcher& filter)
     {
-        if (filter.empty()) {
-            return true;
+        // 其他工作线程正在写入的临时文件（无论过滤规则为何都不处理）
+        if (fileName.size() > tempFileSuffix.size()
+            && std::string_view(fileName).substr(fileName.size() - tempFileSuffix.size()) == tempFileSuffix) {
+            return false;
+        }
+        if (!filter.matches(fileName)) {
+            writeLog(LogLevel::WARN, "File MisMatch: ", fileName, " does not match filter: ", filter.str());
+            return false;
         }
+        return true;
+    }
 
+    /**
+     * @brief 编译过滤串，非法时记录日志并抛出异常
+     * @param filter 过滤串
+     * @param mode 匹配方式
+     * @return 预编译的过滤器
+     */
+    inline FilterMatcher compileFilter(const std::string& filter, FilterMatcher::Mode mode)
+    {
         try {
-            std::string regexPattern = "^.*\\.(" + filter + ")$";
-            std::regex re(regexPattern, std::regex_constants::ECMAScript | std::regex_constants::icase);
-            bool isMatch = std::regex_match(fileName, re);
-
-            if (!isMatch) {
-                logMessage(LogLevel::WARN, "File MisMatch: " + fileName + " does not match filter: " + filter);
-                return false;
-            }
-            return true;
+            return FilterMatcher(filter, mode);
         }
         catch (const std::regex_error& e) {
-            logMessage(LogLevel::ERROR, "Invalid regex filter: " + filter + " | Error: " + e.what());
+            writeLog(LogLevel::ERROR, "Invalid regex filter: ", filter, " | Error: ", e.what());
             throw std::runtime_error("Invalid regex filter: " + filter);
         }
     }
@@ -339,7 +2408,7 @@ private:
         if (lowerEncoding == "utf-16le" || lowerEncoding == "utf16le") return "UTF-16LE";
         if (lowerEncoding == "utf-16be" || lowerEncoding == "utf16be") return "UTF-16BE";
 
-        logMessage(LogLevel::WARN, "Unknown encoding name encountered: " + encoding);
+        writeLog(LogLevel::WARN, "Unknown encoding name encountered: ", encoding);
         return encoding;
     }
 };
@@ -0,0 +1,65 @@
+#ifndef HISTOGRAMBUCKETS_H
+#define HISTOGRAMBUCKETS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// HDR 风格对数直方图的桶划分，供 Timer 与 Profiler 共用
+// 小于 16 的值各占一个桶，其余按最高位所在的 2 的幂区间均分为 16 个子桶，相对误差约 6%
+// 只负责值与桶序号之间的换算，计数存储由使用者按各自的并发方式管理
+class HistogramBuckets {
+public:
+    static constexpr int subBucketBits = 4;
+    static constexpr uint64_t subBucketCount = uint64_t(1) << subBucketBits;
+    static constexpr size_t bucketCount = (64 - subBucketBits + 1) * subBucketCount;
+
+    static size_t index(uint64_t value) {
+        if (value < subBucketCount) return static_cast<size_t>(value);
+        int msb = 63 - countLeadingZeros(value);
+        int shift = msb - subBucketBits;
+        return static_cast<size_t>((msb - subBucketBits + 1) * subBucketCount + ((value >> shift) & (subBucketCount - 1)));
+    }
+
+    // 桶的下界（含）
+    static uint64_t lowerBound(size_t index) {
+        if (index < subBucketCount) return index;
+        int shift = static_cast<int>(index / subBucketCount) - 1;
+        return (subBucketCount + index % subBucketCount) << shift;
+    }
+
+    // 桶的上界（含）
+    static uint64_t upperBound(size_t index) {
+        if (index < subBucketCount) return index;
+        int shift = static_cast<int>(index / subBucketCount) - 1;
+        return lowerBound(index) + (uint64_t(1) << shift) - 1;
+    }
+
+    // 桶的代表值（区间中点）
+    static uint64_t midpoint(size_t index) {
+        if (index < subBucketCount) return index;
+        int shift = static_cast<int>(index / subBucketCount) - 1;
+        return lowerBound(index) + ((uint64_t(1) << shift) >> 1);
+    }
+
+private:
+    // value 不为 0
+    static int countLeadingZeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long msb;
+        _BitScanReverse64(&msb, value);
+        return 63 - static_cast<int>(msb);
+#else
+        int n = 0;
+        for (uint64_t bit = uint64_t(1) << 63; !(value & bit); bit >>= 1) ++n;
+        return n;
+#endif
+    }
+};
+
+#endif // HISTOGRAMBUCKETS_H
@@ -6,19 +6,148 @@
 #include <fstream>
 #include <sstream>
 #include <vector>
+#include <memory>
+#include <string>
+#include <array>
+#include <cerrno>
+#include <cstring>
 #include <openssl/evp.h>
 #include <openssl/pem.h>
 #include <openssl/err.h>
 #include <openssl/sha.h>
 
+#include "ThreadPool.h"
+#include "TimeCal.h"
+
+// 定义 SIGN_VERIFY_HAVE_BLAKE3 并链接官方 BLAKE3 C 库后可使用 DigestAlgorithm::BLAKE3
+#ifdef SIGN_VERIFY_HAVE_BLAKE3
+#include <blake3.h>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 // 错误处理辅助函数
-void handleOpenSSLErrors() {
+inline void handleOpenSSLErrors() {
     ERR_print_errors_fp(stderr);
     abort();
 }
 
+// 操作结果：记录错误类别、出错位置、errno 与 OpenSSL 错误队列中的错误码
+// 构造与复制都不分配内存，只有调用 toString() 时才格式化错误信息
+class CryptoStatus {
+public:
+    enum class Code {
+        Ok,                 // 成功
+        InvalidSignature,   // 签名不匹配
+        FileError,          // 打开或读取文件失败，见 systemError()
+        KeyError,           // 密钥读取失败或未加载
+        Unsupported,        // 当前密钥类型或构建配置不支持该操作
+        OpenSSLError        // OpenSSL 调用失败，见 opensslError()
+    };
+
+    static constexpr size_t maxErrors = 8;  // 最多保留的 OpenSSL 错误码数量
+
+    CryptoStatus() = default;
+
+    static inline CryptoStatus ok() {
+        return CryptoStatus();
+    }
+
+    // 创建失败状态并取走当前线程 OpenSSL 错误队列中的错误码（超过 maxErrors 的部分被丢弃）
+    // context 需为字符串字面量等静态字符串
+    static inline CryptoStatus fromOpenSSL(Code code, const char* context) {
+        CryptoStatus status(code, context);
+        while (unsigned long error = ERR_get_error()) {
+            if (status.errorCount < maxErrors) {
+                status.errors[status.errorCount++] = error;
+            }
+        }
+        return status;
+    }
+
+    // 创建不来自 OpenSSL 的失败状态（如密钥未加载、不支持的操作），不读取 OpenSSL 错误队列
+    // context 需为字符串字面量等静态字符串
+    static inline CryptoStatus failure(Code code, const char* context) {
+        return CryptoStatus(code, context);
+    }
+
+    // 创建文件错误状态，记录 errno
+    static inline CryptoStatus fromErrno(const char* context, int error) {
+        CryptoStatus status(Code::FileError, context);
+        status.sysError = error;
+        return status;
+    }
+
+    inline bool isOk() const {
+        return statusCode == Code::Ok;
+    }
+
+    explicit operator bool() const {
+        return isOk();
+    }
+
+    inline Code code() const {
+        return statusCode;
+    }
+
+    inline const char* context() const {
+        return where;
+    }
+
+    inline int systemError() const {
+        return sysError;
+    }
+
+    inline size_t opensslErrorCount() const {
+        return errorCount;
+    }
+
+    inline unsigned long opensslError(size_t index) const {
+        return index < errorCount ? errors[index] : 0;
+    }
+
+    // 格式化为可读的错误信息
+    inline std::string toString() const {
+        if (isOk()) return "OK";
+
+        std::string text = where ? where : "Error";
+        if (sysError != 0) {
+            text += ": ";
+            text += std::strerror(sysError);
+        }
+        for (size_t i = 0; i < errorCount; ++i) {
+            char buffer[256];
+            ERR_error_string_n(errors[i], buffer, sizeof(buffer));
+            text += i == 0 ? ": " : "; ";
+            text += buffer;
+        }
+        return text;
+    }
+
+private:
+    CryptoStatus(Code code, const char* context)
+        : statusCode(code), where(context) {
+    }
+
+    Code statusCode = Code::Ok;
+    const char* where = nullptr;                    // 出错位置（静态字符串）
+    int sysError = 0;                               // errno，0 表示无
+    size_t errorCount = 0;                          // 有效的 OpenSSL 错误码数量
+    std::array<unsigned long, maxErrors> errors{};  // OpenSSL 错误码
+};
+
+// 输出错误信息并中止，供保留原有中止行为的接口使用
+[[noreturn]] inline void abortWithStatus(const CryptoStatus& status) {
+    std::cerr << status.toString() << std::endl;
+    abort();
+}
+
 // 计算 SHA-256 哈希
-std::vector<unsigned char> computeSHA256(const std::string& data) {
+inline std::vector<unsigned char> computeSHA256(const std::string& data) {
+    HEADONLY_PROFILE_SCOPE("Sign_Verify::computeSHA256");
     std::vector<unsigned char> hash(SHA256_DIGEST_LENGTH);
     if (!SHA256(reinterpret_cast<const unsigned char*>(data.c_str()), data.size(), hash.data())) {
         std::cerr << "SHA256 computation failed." << std::endl;
@@ -27,96 +156,630 @@ std::vector<unsigned char> computeSHA256(const std::string& data) {
     return hash;
 }
 
-// 使用私钥签名哈希
-std::vector<unsigned char> signHash(const std::vector<unsigned char>& hash, const std::string& privateKeyPath) {
-    // 打开私钥文件
-    std::ifstream keyFile(privateKeyPath, std::ios::binary);
-    if (!keyFile.is_open()) {
-        std::cerr << "Unable to open private key file: " << privateKeyPath << std::endl;
-        exit(EXIT_FAILURE);
+// 可选的哈希算法，OpenSSL 会按 CPU 能力自动选用 SHA-NI、AVX2 等加速实现
+// 在不支持 SHA-NI 的 64 位 CPU 上，SHA-512/256 通常比 SHA-256 更快
+enum class DigestAlgorithm {
+    SHA256,         // SHA-256（默认，签名使用）
+    SHA512_256,     // SHA-512/256
+    BLAKE2b512,     // BLAKE2b-512
+    BLAKE3          // BLAKE3-256，需定义 SIGN_VERIFY_HAVE_BLAKE3
+};
+
+// 获取算法名称
+inline const char* digestName(DigestAlgorithm algorithm) {
+    switch (algorithm) {
+    case DigestAlgorithm::SHA256: return "SHA256";
+    case DigestAlgorithm::SHA512_256: return "SHA512-256";
+    case DigestAlgorithm::BLAKE2b512: return "BLAKE2B-512";
+    case DigestAlgorithm::BLAKE3: return "BLAKE3";
     }
+    return "";
+}
 
-    // 读取私钥
-    std::stringstream keyStream;
-    keyStream << keyFile.rdbuf();
-    std::string keyStr = keyStream.str();
-    BIO* bio = BIO_new_mem_buf(keyStr.c_str(), -1);
-    EVP_PKEY* privateKey = PEM_read_bio_PrivateKey(bio, nullptr, nullptr, nullptr);
-    BIO_free(bio);
-    keyFile.close();
+// 获取 OpenSSL 摘要算法，BLAKE3 或当前 OpenSSL 不提供时返回空
+// OpenSSL 3 下每种算法只显式获取一次，避免每次初始化时隐式查找算法实现
+inline const EVP_MD* evpDigest(DigestAlgorithm algorithm) {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    using FetchedDigest = std::unique_ptr<EVP_MD, decltype(&EVP_MD_free)>;
+    static const FetchedDigest digests[] = {
+        FetchedDigest(EVP_MD_fetch(nullptr, digestName(DigestAlgorithm::SHA256), nullptr), &EVP_MD_free),
+        FetchedDigest(EVP_MD_fetch(nullptr, digestName(DigestAlgorithm::SHA512_256), nullptr), &EVP_MD_free),
+        FetchedDigest(EVP_MD_fetch(nullptr, digestName(DigestAlgorithm::BLAKE2b512), nullptr), &EVP_MD_free),
+    };
+    if (algorithm == DigestAlgorithm::BLAKE3) return nullptr;
+    const EVP_MD* md = digests[static_cast<int>(algorithm)].get();
+    if (md) return md;
+    ERR_clear_error();
+#endif
+    switch (algorithm) {
+    case DigestAlgorithm::SHA256: return EVP_sha256();
+    case DigestAlgorithm::SHA512_256: return EVP_sha512_256();
+    case DigestAlgorithm::BLAKE2b512: return EVP_blake2b512();
+    default: return nullptr;
+    }
+}
 
-    if (!privateKey) {
-        std::cerr << "Error reading private key." << std::endl;
-        handleOpenSSLErrors();
+// 判断当前构建与运行环境是否支持指定算法
+inline bool isDigestAvailable(DigestAlgorithm algorithm) {
+#ifdef SIGN_VERIFY_HAVE_BLAKE3
+    if (algorithm == DigestAlgorithm::BLAKE3) return true;
+#endif
+    return evpDigest(algorithm) != nullptr;
+}
+
+// 获取 SHA-256 摘要算法
+inline const EVP_MD* sha256Digest() {
+    return evpDigest(DigestAlgorithm::SHA256);
+}
+
+// 获取当前线程复用的摘要上下文，每次使用前由 Init 重新初始化，创建失败时返回空
+inline EVP_MD_CTX* threadDigestContext() {
+    thread_local std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+    return ctx.get();
+}
+
+// 增量哈希计算器：init 后可多次 update，final 输出摘要，之后可再次 init 复用
+// 出错时不中止：错误记录在 status() 中，之后的 update 被忽略，final 返回空摘要
+// 每个对象持有自己的摘要上下文，不能在多个线程中同时使用同一对象
+class Hasher {
+public:
+    explicit Hasher(DigestAlgorithm algorithm = DigestAlgorithm::SHA256)
+        : algorithm(algorithm),
+        ctx(algorithm == DigestAlgorithm::BLAKE3 ? nullptr : EVP_MD_CTX_new(), &EVP_MD_CTX_free) {
+        init();
+    }
+
+    // 开始新的哈希计算（构造时已自动调用一次），同时清除之前的错误
+    inline void init() {
+        currentStatus = CryptoStatus::ok();
+        if (algorithm == DigestAlgorithm::BLAKE3) {
+#ifdef SIGN_VERIFY_HAVE_BLAKE3
+            blake3_hasher_init(&blake3);
+#else
+            currentStatus = CryptoStatus::failure(CryptoStatus::Code::Unsupported, "BLAKE3 is not available in this build");
+#endif
+            return;
+        }
+
+        const EVP_MD* md = evpDigest(algorithm);
+        if (!ctx) {
+            currentStatus = CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "EVP_MD_CTX_new");
+        } else if (!md) {
+            currentStatus = CryptoStatus::failure(CryptoStatus::Code::Unsupported, "Digest algorithm is not available");
+        } else if (EVP_DigestInit_ex(ctx.get(), md, nullptr) != 1) {
+            currentStatus = CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "EVP_DigestInit_ex");
+        }
+    }
+
+    // 追加数据
+    inline void update(const void* data, size_t size) {
+        if (!currentStatus) return;
+#ifdef SIGN_VERIFY_HAVE_BLAKE3
+        if (algorithm == DigestAlgorithm::BLAKE3) {
+            blake3_hasher_update(&blake3, data, size);
+            return;
+        }
+#endif
+        if (EVP_DigestUpdate(ctx.get(), data, size) != 1) {
+            currentStatus = CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "EVP_DigestUpdate");
+        }
+    }
+
+    inline void update(const std::string& data) {
+        update(data.data(), data.size());
+    }
+
+    // 结束计算并返回摘要，出错时返回空
+    inline std::vector<unsigned char> final() {
+        if (!currentStatus) return {};
+#ifdef SIGN_VERIFY_HAVE_BLAKE3
+        if (algorithm == DigestAlgorithm::BLAKE3) {
+            std::vector<unsigned char> hash(BLAKE3_OUT_LEN);
+            blake3_hasher_finalize(&blake3, hash.data(), hash.size());
+            return hash;
+        }
+#endif
+
+        std::vector<unsigned char> hash(EVP_MAX_MD_SIZE);
+        unsigned int hashLen = 0;
+        if (EVP_DigestFinal_ex(ctx.get(), hash.data(), &hashLen) != 1) {
+            currentStatus = CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "EVP_DigestFinal_ex");
+            return {};
+        }
+        hash.resize(hashLen);
+        return hash;
     }
 
-    // 创建签名上下文
-    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
-    if (!ctx) handleOpenSSLErrors();
+    // 本轮计算的状态
+    inline const CryptoStatus& status() const {
+        return currentStatus;
+    }
 
-    if (EVP_SignInit(ctx, EVP_sha256()) != 1) handleOpenSSLErrors();
-    if (EVP_SignUpdate(ctx, hash.data(), hash.size()) != 1) handleOpenSSLErrors();
+    // 使用的哈希算法
+    inline DigestAlgorithm digestAlgorithm() const {
+        return algorithm;
+    }
 
-    // 分配足够的内存存储签名
-    unsigned int sigLen = EVP_PKEY_size(privateKey);
-    std::vector<unsigned char> signature(sigLen);
+private:
+    DigestAlgorithm algorithm;                                      // 哈希算法
+    std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx;   // 摘要上下文（BLAKE3 不使用）
+#ifdef SIGN_VERIFY_HAVE_BLAKE3
+    blake3_hasher blake3;                                           // BLAKE3 状态
+#endif
+    CryptoStatus currentStatus;                                     // 本轮计算的状态
+};
 
-    if (EVP_SignFinal(ctx, signature.data(), &sigLen, privateKey) != 1) handleOpenSSLErrors();
-    EVP_MD_CTX_free(ctx);
-    EVP_PKEY_free(privateKey);
+// 使用指定算法计算数据的哈希，失败时返回错误状态
+inline CryptoStatus computeDigest(const void* data, size_t size, DigestAlgorithm algorithm, std::vector<unsigned char>& hash) {
+    HEADONLY_PROFILE_SCOPE("Sign_Verify::computeDigest");
+    Hasher hasher(algorithm);
+    hasher.update(data, size);
+    hash = hasher.final();
+    return hasher.status();
+}
+
+// 按固定大小的块顺序读取文件，每块调用 consume(data, size)，内存占用与文件大小无关
+template <typename Consumer>
+inline CryptoStatus readFileChunks(const std::string& filePath, size_t bufferSize, Consumer&& consume) {
+    std::vector<char> buffer(bufferSize < 4096 ? 4096 : bufferSize);
+
+#ifndef _WIN32
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return CryptoStatus::fromErrno("Unable to open file", errno);
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    while (true) {
+        ssize_t n = read(fd, buffer.data(), buffer.size());
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            int error = errno;
+            close(fd);
+            return CryptoStatus::fromErrno("Error reading file", error);
+        }
+        if (n == 0) break;
+        consume(buffer.data(), static_cast<size_t>(n));
+    }
+    close(fd);
+#else
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        return CryptoStatus::fromErrno("Unable to open file", errno);
+    }
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (file.gcount() > 0) consume(buffer.data(), static_cast<size_t>(file.gcount()));
+    }
+    if (file.bad()) {
+        return CryptoStatus::fromErrno("Error reading file", errno);
+    }
+#endif
+    return CryptoStatus::ok();
+}
+
+// 按固定大小的块顺序读取输入流，每块调用 consume(data, size)
+template <typename Consumer>
+inline CryptoStatus readStreamChunks(std::istream& in, size_t bufferSize, Consumer&& consume) {
+    std::vector<char> buffer(bufferSize < 4096 ? 4096 : bufferSize);
+    while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (in.gcount() > 0) consume(buffer.data(), static_cast<size_t>(in.gcount()));
+    }
+    if (in.bad()) {
+        return CryptoStatus::fromErrno("Error reading stream", errno);
+    }
+    return CryptoStatus::ok();
+}
 
-    // 调整签名大小
-    signature.resize(sigLen);
-    return signature;
+// 将文件内容按固定大小的块顺序送入 hasher，内存占用与文件大小无关
+inline CryptoStatus hashFileInto(const std::string& filePath, Hasher& hasher, size_t bufferSize = 1024 * 1024) {
+    HEADONLY_PROFILE_SCOPE("Sign_Verify::hashFile");
+    CryptoStatus status = readFileChunks(filePath, bufferSize, [&hasher](const char* data, size_t size) {
+        hasher.update(data, size);
+    });
+    return status ? hasher.status() : status;
 }
 
-// 使用公钥验证签名
-bool verifySignature(const std::vector<unsigned char>& hash, const std::vector<unsigned char>& signature, const std::string& publicKeyPath) {
-    // 打开公钥文件
-    std::ifstream keyFile(publicKeyPath, std::ios::binary);
-    if (!keyFile.is_open()) {
-        std::cerr << "Unable to open public key file: " << publicKeyPath << std::endl;
+// 计算文件的哈希（默认 SHA-256），失败时返回错误状态而不终止进程
+inline CryptoStatus hashFile(const std::string& filePath, std::vector<unsigned char>& hash, size_t bufferSize = 1024 * 1024,
+                             DigestAlgorithm algorithm = DigestAlgorithm::SHA256) {
+    Hasher hasher(algorithm);
+    CryptoStatus status = hashFileInto(filePath, hasher, bufferSize);
+    if (!status) return status;
+    hash = hasher.final();
+    return hasher.status();
+}
+
+// 计算文件的哈希（默认 SHA-256），按固定大小的块顺序读取，内存占用与文件大小无关
+// 默认每次读取 1 MB，并提示内核按顺序预读；失败时输出错误并退出
+inline std::vector<unsigned char> hashFile(const std::string& filePath, size_t bufferSize = 1024 * 1024,
+                                           DigestAlgorithm algorithm = DigestAlgorithm::SHA256) {
+    std::vector<unsigned char> hash;
+    CryptoStatus status = hashFile(filePath, hash, bufferSize, algorithm);
+    if (!status) {
+        std::cerr << status.toString() << ": " << filePath << std::endl;
         exit(EXIT_FAILURE);
     }
+    return hash;
+}
+
+// 从 PEM 文件读取密钥（直接由 BIO 读取文件，不经过 ifstream 与 stringstream 复制），失败时返回错误状态
+inline CryptoStatus loadPemKey(const std::string& keyPath, bool isPrivate, std::shared_ptr<EVP_PKEY>& key) {
+    HEADONLY_PROFILE_SCOPE("Sign_Verify::loadPemKey");
+    BIO* bio = BIO_new_file(keyPath.c_str(), "rb");
+    if (!bio) {
+        return CryptoStatus::fromOpenSSL(CryptoStatus::Code::FileError,
+                                         isPrivate ? "Unable to open private key file" : "Unable to open public key file");
+    }
 
-    // 读取公钥
-    std::stringstream keyStream;
-    keyStream << keyFile.rdbuf();
-    std::string keyStr = keyStream.str();
-    BIO* bio = BIO_new_mem_buf(keyStr.c_str(), -1);
-    EVP_PKEY* publicKey = PEM_read_bio_PUBKEY(bio, nullptr, nullptr, nullptr);
+    EVP_PKEY* pkey = isPrivate ? PEM_read_bio_PrivateKey(bio, nullptr, nullptr, nullptr)
+                               : PEM_read_bio_PUBKEY(bio, nullptr, nullptr, nullptr);
     BIO_free(bio);
-    keyFile.close();
 
-    if (!publicKey) {
-        std::cerr << "Error reading public key." << std::endl;
-        handleOpenSSLErrors();
+    if (!pkey) {
+        return CryptoStatus::fromOpenSSL(CryptoStatus::Code::KeyError,
+                                         isPrivate ? "Error reading private key" : "Error reading public key");
+    }
+    key.reset(pkey, &EVP_PKEY_free);
+    return CryptoStatus::ok();
+}
+
+// 从 PEM 文件读取密钥，无法打开文件时退出，解析失败时中止
+inline std::shared_ptr<EVP_PKEY> loadPemKey(const std::string& keyPath, bool isPrivate) {
+    std::shared_ptr<EVP_PKEY> key;
+    CryptoStatus status = loadPemKey(keyPath, isPrivate, key);
+    if (status.code() == CryptoStatus::Code::FileError) {
+        std::cerr << status.context() << ": " << keyPath << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    if (!status) abortWithStatus(status);
+    return key;
+}
+
+// Ed25519/Ed448 只支持一次性签名：内置哈希，不能分块输入，也不能对预先计算的摘要签名
+inline bool isOneShotKey(const EVP_PKEY* key) {
+    int id = EVP_PKEY_id(key);
+    return id == EVP_PKEY_ED25519 || id == EVP_PKEY_ED448;
+}
+
+// 直接签名/验证数据时使用的摘要算法，一次性签名的密钥返回空
+inline const EVP_MD* signatureDigest(const EVP_PKEY* key) {
+    return isOneShotKey(key) ? nullptr : sha256Digest();
+}
+
+// 对数据签名或验证的公共流程：RSA/ECDSA 分块送入 EVP_DigestSign/VerifyUpdate，只遍历一次数据；
+// Ed25519/Ed448 先收集全部数据再一次性处理（其算法需要两次遍历消息，无法流式计算）
+// feed(consume) 负责把数据逐块交给 consume 并返回读取状态；
+// finish(ctx, oneShot, message, size) 完成签名或验证，oneShot 为 false 时 message 为空
+template <typename Init, typename Update, typename Feed, typename Finish>
+inline CryptoStatus digestSignOrVerify(EVP_PKEY* key, Init&& init, Update&& update, Feed&& feed, Finish&& finish) {
+    EVP_MD_CTX* ctx = threadDigestContext();
+    if (!ctx) return CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "EVP_MD_CTX_new");
+    EVP_MD_CTX_reset(ctx);
+    if (init(ctx, signatureDigest(key), key) != 1) {
+        return CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "Error initializing digest signature");
+    }
+
+    if (isOneShotKey(key)) {
+        std::string message;
+        CryptoStatus status = feed([&message](const char* data, size_t size) { message.append(data, size); });
+        if (!status) return status;
+        return finish(ctx, true, reinterpret_cast<const unsigned char*>(message.data()), message.size());
+    }
+
+    bool updated = true;
+    CryptoStatus status = feed([&](const char* data, size_t size) {
+        if (updated && update(ctx, data, size) != 1) updated = false;
+    });
+    if (!status) return status;
+    if (!updated) return CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "Error updating digest signature");
+    return finish(ctx, false, nullptr, 0);
+}
+
+// 签名器：构造时加载一次私钥并常驻，sign 可在多个线程中并发调用
+// 拷贝 Signer 只增加私钥的引用计数
+class Signer {
+public:
+    // 加载私钥，无法打开文件时退出，解析失败时中止
+    explicit Signer(const std::string& privateKeyPath)
+        : privateKey(loadPemKey(privateKeyPath, true)) {
+    }
+
+    // 加载私钥，失败时通过 status 返回错误而不终止进程，此后 sign 返回 KeyError
+    Signer(const std::string& privateKeyPath, CryptoStatus& status) {
+        status = loadPemKey(privateKeyPath, true, privateKey);
+    }
+
+    // 使用私钥签名哈希，失败时中止
+    inline std::vector<unsigned char> sign(const std::vector<unsigned char>& hash) const {
+        std::vector<unsigned char> signature;
+        CryptoStatus status = sign(hash, signature);
+        if (!status) abortWithStatus(status);
+        return signature;
+    }
+
+    // 使用私钥签名哈希，失败时返回错误状态
+    inline CryptoStatus sign(const std::vector<unsigned char>& hash, std::vector<unsigned char>& signature) const {
+        HEADONLY_PROFILE_SCOPE("Signer::sign");
+        if (!privateKey) return CryptoStatus::failure(CryptoStatus::Code::KeyError, "Private key not loaded");
+        EVP_MD_CTX* ctx = threadDigestContext();
+        if (!ctx) return CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "EVP_MD_CTX_new");
+
+        // 上下文可能刚被 digestSign/digestVerify 绑定过其他密钥，先重置
+        EVP_MD_CTX_reset(ctx);
+        if (EVP_SignInit_ex(ctx, sha256Digest(), nullptr) != 1 || EVP_SignUpdate(ctx, hash.data(), hash.size()) != 1) {
+            return CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "Error initializing signature");
+        }
+
+        // 分配足够的内存存储签名
+        unsigned int sigLen = EVP_PKEY_size(privateKey.get());
+        signature.resize(sigLen);
+
+        if (EVP_SignFinal(ctx, signature.data(), &sigLen, privateKey.get()) != 1) {
+            return CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "Error creating signature");
+        }
+
+        // 调整签名大小
+        signature.resize(sigLen);
+        return CryptoStatus::ok();
+    }
+
+    // 直接对数据签名（EVP_DigestSign，SHA-256；Ed25519/Ed448 使用其内置哈希），数据只哈希一次
+    inline CryptoStatus signData(const void* data, size_t size, std::vector<unsigned char>& signature) const {
+        return digestSign([data, size](auto&& consume) {
+            consume(static_cast<const char*>(data), size);
+            return CryptoStatus::ok();
+        }, signature);
+    }
+
+    // 一次遍历对输入流签名（Ed25519/Ed448 需在内存中保留全部数据）
+    inline CryptoStatus signStream(std::istream& in, std::vector<unsigned char>& signature, size_t bufferSize = 1024 * 1024) const {
+        return digestSign([&in, bufferSize](auto&& consume) {
+            return readStreamChunks(in, bufferSize, consume);
+        }, signature);
+    }
+
+    // 一次遍历对文件签名（Ed25519/Ed448 需在内存中保留全部数据）
+    inline CryptoStatus signFile(const std::string& filePath, std::vector<unsigned char>& signature, size_t bufferSize = 1024 * 1024) const {
+        return digestSign([&filePath, bufferSize](auto&& consume) {
+            return readFileChunks(filePath, bufferSize, consume);
+        }, signature);
+    }
+
+    // 对调用者已计算的 SHA-256 摘要直接签名（EVP_PKEY_sign），不再次哈希
+    // 结果与对原始数据调用 signData 等价，可用 Verifier::verifyData 验证；Ed25519/Ed448 不支持此模式
+    inline CryptoStatus signDigest(const std::vector<unsigned char>& digest, std::vector<unsigned char>& signature) const {
+        HEADONLY_PROFILE_SCOPE("Signer::signDigest");
+        if (!privateKey) return CryptoStatus::failure(CryptoStatus::Code::KeyError, "Private key not loaded");
+        if (isOneShotKey(privateKey.get())) {
+            return CryptoStatus::failure(CryptoStatus::Code::Unsupported, "Raw digest signing is not supported by this key type");
+        }
+
+        std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> ctx(EVP_PKEY_CTX_new(privateKey.get(), nullptr), &EVP_PKEY_CTX_free);
+        size_t sigLen = 0;
+        if (!ctx || EVP_PKEY_sign_init(ctx.get()) != 1
+            || EVP_PKEY_CTX_set_signature_md(ctx.get(), sha256Digest()) != 1
+            || EVP_PKEY_sign(ctx.get(), nullptr, &sigLen, digest.data(), digest.size()) != 1) {
+            return CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "Error initializing digest signature");
+        }
+        signature.resize(sigLen);
+        if (EVP_PKEY_sign(ctx.get(), signature.data(), &sigLen, digest.data(), digest.size()) != 1) {
+            return CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "Error creating signature");
+        }
+        signature.resize(sigLen);
+        return CryptoStatus::ok();
+    }
+
+private:
+    template <typename Feed>
+    inline CryptoStatus digestSign(Feed&& feed, std::vector<unsigned char>& signature) const {
+        HEADONLY_PROFILE_SCOPE("Signer::digestSign");
+        if (!privateKey) return CryptoStatus::failure(CryptoStatus::Code::KeyError, "Private key not loaded");
+        return digestSignOrVerify(privateKey.get(),
+            [](EVP_MD_CTX* ctx, const EVP_MD* md, EVP_PKEY* key) { return EVP_DigestSignInit(ctx, nullptr, md, nullptr, key); },
+            [](EVP_MD_CTX* ctx, const char* data, size_t size) { return EVP_DigestSignUpdate(ctx, data, size); },
+            feed,
+            [&signature](EVP_MD_CTX* ctx, bool oneShot, const unsigned char* message, size_t messageSize) {
+                size_t sigLen = 0;
+                int ok = oneShot ? EVP_DigestSign(ctx, nullptr, &sigLen, message, messageSize)
+                                 : EVP_DigestSignFinal(ctx, nullptr, &sigLen);
+                if (ok == 1) {
+                    signature.resize(sigLen);
+                    ok = oneShot ? EVP_DigestSign(ctx, signature.data(), &sigLen, message, messageSize)
+                                 : EVP_DigestSignFinal(ctx, signature.data(), &sigLen);
+                }
+                if (ok != 1) return CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "Error creating signature");
+                signature.resize(sigLen);
+                return CryptoStatus::ok();
+            });
+    }
+
+    std::shared_ptr<EVP_PKEY> privateKey;   // 私钥
+};
+
+// 批量验证的单个输入：文件路径与对该文件 SHA-256 哈希的签名
+struct VerifyItem {
+    std::string filePath;
+    std::vector<unsigned char> signature;
+};
+
+// 批量验证的单个结果
+struct VerifyResult {
+    enum class Outcome {
+        Valid,      // 签名有效
+        Invalid,    // 签名不匹配
+        Error       // 读取文件或验证过程出错，原因见 status
+    };
+    Outcome outcome = Outcome::Error;
+    CryptoStatus status;
+};
+
+// 验证器：构造时加载一次公钥并常驻，verify 可在多个线程中并发调用，不输出任何信息
+// 拷贝 Verifier 只增加公钥的引用计数
+class Verifier {
+public:
+    // 加载公钥，无法打开文件时退出，解析失败时中止
+    explicit Verifier(const std::string& publicKeyPath)
+        : publicKey(loadPemKey(publicKeyPath, false)) {
+    }
+
+    // 加载公钥，失败时通过 status 返回错误而不终止进程，此后 check 返回 KeyError
+    Verifier(const std::string& publicKeyPath, CryptoStatus& status) {
+        status = loadPemKey(publicKeyPath, false, publicKey);
+    }
+
+    // 使用公钥验证签名，签名不匹配返回 false，验证过程出错时中止
+    inline bool verify(const std::vector<unsigned char>& hash, const std::vector<unsigned char>& signature) const {
+        CryptoStatus status = check(hash, signature);
+        if (status.code() == CryptoStatus::Code::InvalidSignature) return false;
+        if (!status) abortWithStatus(status);
+        return true;
+    }
+
+    // 使用公钥验证签名，返回 Ok、InvalidSignature 或错误状态，不输出任何信息也不终止进程
+    inline CryptoStatus check(const std::vector<unsigned char>& hash, const std::vector<unsigned char>& signature) const {
+        HEADONLY_PROFILE_SCOPE("Verifier::check");
+        if (!publicKey) return CryptoStatus::failure(CryptoStatus::Code::KeyError, "Public key not loaded");
+        EVP_MD_CTX* ctx = threadDigestContext();
+        if (!ctx) return CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "EVP_MD_CTX_new");
+
+        // 上下文可能刚被 digestSign/digestVerify 绑定过其他密钥，先重置
+        EVP_MD_CTX_reset(ctx);
+        if (EVP_VerifyInit_ex(ctx, sha256Digest(), nullptr) != 1 || EVP_VerifyUpdate(ctx, hash.data(), hash.size()) != 1) {
+            return CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "Error initializing verification");
+        }
+
+        return verifyStatus(EVP_VerifyFinal(ctx, signature.data(), static_cast<unsigned int>(signature.size()), publicKey.get()));
+    }
+
+    // 直接验证对数据的签名（EVP_DigestVerify，与 Signer::signData/signStream/signFile 对应）
+    inline CryptoStatus verifyData(const void* data, size_t size, const std::vector<unsigned char>& signature) const {
+        return digestVerify([data, size](auto&& consume) {
+            consume(static_cast<const char*>(data), size);
+            return CryptoStatus::ok();
+        }, signature);
+    }
+
+    // 一次遍历验证对输入流的签名
+    inline CryptoStatus verifyStream(std::istream& in, const std::vector<unsigned char>& signature, size_t bufferSize = 1024 * 1024) const {
+        return digestVerify([&in, bufferSize](auto&& consume) {
+            return readStreamChunks(in, bufferSize, consume);
+        }, signature);
     }
 
-    // 创建验证上下文
-    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
-    if (!ctx) handleOpenSSLErrors();
+    // 一次遍历验证对文件的签名
+    inline CryptoStatus verifyFile(const std::string& filePath, const std::vector<unsigned char>& signature, size_t bufferSize = 1024 * 1024) const {
+        return digestVerify([&filePath, bufferSize](auto&& consume) {
+            return readFileChunks(filePath, bufferSize, consume);
+        }, signature);
+    }
+
+    // 对调用者已计算的 SHA-256 摘要直接验证签名（EVP_PKEY_verify），Ed25519/Ed448 不支持此模式
+    inline CryptoStatus verifyDigest(const std::vector<unsigned char>& digest, const std::vector<unsigned char>& signature) const {
+        HEADONLY_PROFILE_SCOPE("Verifier::verifyDigest");
+        if (!publicKey) return CryptoStatus::failure(CryptoStatus::Code::KeyError, "Public key not loaded");
+        if (isOneShotKey(publicKey.get())) {
+            return CryptoStatus::failure(CryptoStatus::Code::Unsupported, "Raw digest verification is not supported by this key type");
+        }
+
+        std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> ctx(EVP_PKEY_CTX_new(publicKey.get(), nullptr), &EVP_PKEY_CTX_free);
+        if (!ctx || EVP_PKEY_verify_init(ctx.get()) != 1 || EVP_PKEY_CTX_set_signature_md(ctx.get(), sha256Digest()) != 1) {
+            return CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "Error initializing verification");
+        }
+        return verifyStatus(EVP_PKEY_verify(ctx.get(), signature.data(), signature.size(), digest.data(), digest.size()));
+    }
 
-    if (EVP_VerifyInit(ctx, EVP_sha256()) != 1) handleOpenSSLErrors();
-    if (EVP_VerifyUpdate(ctx, hash.data(), hash.size()) != 1) handleOpenSSLErrors();
+    // 批量验证文件签名：哈希计算与验证分发到线程池并行执行，所有线程共享本对象的公钥
+    // 结果与 items 一一对应；单个文件出错只影响其自身结果，不输出任何信息
+    // threadCount 为 0 时使用硬件并发数
+    inline std::vector<VerifyResult> verifyFiles(const std::vector<VerifyItem>& items, size_t threadCount = 0) const {
+        std::vector<VerifyResult> results(items.size());
+        ThreadPool pool(threadCount);
+        for (size_t i = 0; i < items.size(); ++i) {
+            pool.submit([this, &items, &results, i]() {
+                results[i] = verifyBatchItem(items[i]);
+            });
+        }
+        pool.waitIdle();
+        return results;
+    }
 
-    // 验证签名
-    int result = EVP_VerifyFinal(ctx, signature.data(), signature.size(), publicKey);
-    EVP_MD_CTX_free(ctx);
-    EVP_PKEY_free(publicKey);
+private:
+    // 将验证函数的返回值转换为状态：1 有效，0 不匹配，其余为错误
+    static inline CryptoStatus verifyStatus(int result) {
+        if (result == 1) return CryptoStatus::ok();
+        if (result == 0) {
+            // 签名不匹配时错误队列中会留下解析错误，清除以免影响后续调用
+            ERR_clear_error();
+            return CryptoStatus::failure(CryptoStatus::Code::InvalidSignature, "Signature verification failed");
+        }
+        return CryptoStatus::fromOpenSSL(CryptoStatus::Code::OpenSSLError, "Error during signature verification");
+    }
 
-    if (result == 1) {
+    template <typename Feed>
+    inline CryptoStatus digestVerify(Feed&& feed, const std::vector<unsigned char>& signature) const {
+        HEADONLY_PROFILE_SCOPE("Verifier::digestVerify");
+        if (!publicKey) return CryptoStatus::failure(CryptoStatus::Code::KeyError, "Public key not loaded");
+        return digestSignOrVerify(publicKey.get(),
+            [](EVP_MD_CTX* ctx, const EVP_MD* md, EVP_PKEY* key) { return EVP_DigestVerifyInit(ctx, nullptr, md, nullptr, key); },
+            [](EVP_MD_CTX* ctx, const char* data, size_t size) { return EVP_DigestVerifyUpdate(ctx, data, size); },
+            feed,
+            [&signature](EVP_MD_CTX* ctx, bool oneShot, const unsigned char* message, size_t messageSize) {
+                return verifyStatus(oneShot ? EVP_DigestVerify(ctx, signature.data(), signature.size(), message, messageSize)
+                                            : EVP_DigestVerifyFinal(ctx, signature.data(), signature.size()));
+            });
+    }
+
+    inline VerifyResult verifyBatchItem(const VerifyItem& item) const {
+        HEADONLY_PROFILE_SCOPE("Verifier::verifyBatchItem");
+        VerifyResult result;
+        thread_local Hasher hasher;
+        hasher.init();
+        result.status = hashFileInto(item.filePath, hasher);
+        if (!result.status) return result;
+
+        std::vector<unsigned char> hash = hasher.final();
+        result.status = hasher.status();
+        if (!result.status) return result;
+
+        result.status = check(hash, item.signature);
+        if (result.status) {
+            result.outcome = VerifyResult::Outcome::Valid;
+        } else if (result.status.code() == CryptoStatus::Code::InvalidSignature) {
+            result.outcome = VerifyResult::Outcome::Invalid;
+        }
+        return result;
+    }
+
+    std::shared_ptr<EVP_PKEY> publicKey;    // 公钥
+};
+
+// 使用私钥签名哈希（每次调用都会加载私钥，需多次签名时请复用 Signer）
+inline std::vector<unsigned char> signHash(const std::vector<unsigned char>& hash, const std::string& privateKeyPath) {
+    return Signer(privateKeyPath).sign(hash);
+}
+
+// 使用公钥验证签名（每次调用都会加载公钥，需多次验证时请复用 Verifier）
+inline bool verifySignature(const std::vector<unsigned char>& hash, const std::vector<unsigned char>& signature, const std::string& publicKeyPath) {
+    if (Verifier(publicKeyPath).verify(hash, signature)) {
         std::cout << "Signature is valid." << std::endl;
         return true;
-    } else if (result == 0) {
-        std::cerr << "Signature verification failed." << std::endl;
-        return false;
     } else {
-        std::cerr << "Error during signature verification." << std::endl;
-        handleOpenSSLErrors();
+        std::cerr << "Signature verification failed." << std::endl;
         return false;
     }
 }
 
+// 使用公钥验证签名，不输出任何信息也不终止进程
+// 返回 Ok 表示签名有效，InvalidSignature 表示不匹配，其余为错误
+inline CryptoStatus checkSignature(const std::vector<unsigned char>& hash, const std::vector<unsigned char>& signature, const std::string& publicKeyPath) {
+    CryptoStatus status;
+    Verifier verifier(publicKeyPath, status);
+    if (!status) return status;
+    return verifier.check(hash, signature);
+}
+
 
 #endif
@@ -0,0 +1,184 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+/**
+ * @brief ThreadPool 类
+ *
+ * 固定线程数的工作窃取线程池。
+ * 每个工作线程拥有自己的任务队列，本队列为空时从其他线程队列的尾部窃取任务。
+ * 排队任务总数受容量上限约束，队列已满时 submit 会阻塞提交线程，
+ * 因此无论提交多少任务，线程数和内存占用都保持恒定。
+ *
+ * 注：任务内部不应再向同一线程池提交任务，否则在队列已满时可能死锁。
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief 构造函数
+     * @param threadCount 工作线程数，为 0 时使用 std::thread::hardware_concurrency()
+     * @param queueCapacity 排队任务上限，为 0 时取工作线程数的 64 倍
+     */
+    explicit ThreadPool(size_t threadCount = 0, size_t queueCapacity = 0)
+    {
+        if (threadCount == 0) {
+            threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        capacity_ = queueCapacity == 0 ? threadCount * 64 : queueCapacity;
+
+        for (size_t i = 0; i < threadCount; ++i) {
+            queues_.emplace_back(std::make_unique<WorkQueue>());
+        }
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers_.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief 析构函数，执行完剩余任务后回收所有工作线程
+     */
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            stopping_ = true;
+        }
+        workAvailable_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    /**
+     * @brief 提交任务，队列已满时阻塞直到有空位
+     * @param task 要执行的任务，任务抛出的异常会被忽略，需由任务自行处理
+     */
+    inline void submit(std::function<void()> task)
+    {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex_);
+            spaceAvailable_.wait(lock, [this]() { return queued_ < capacity_; });
+            ++queued_;
+            ++pending_;
+
+            // 轮询分配到各工作线程的队列，由窃取机制平衡负载
+            size_t index = nextQueue_++ % queues_.size();
+            std::lock_guard<std::mutex> queueLock(queues_[index]->mutex);
+            queues_[index]->tasks.push_back(std::move(task));
+        }
+        workAvailable_.notify_one();
+    }
+
+    /**
+     * @brief 阻塞等待所有已提交的任务执行完毕
+     */
+    inline void waitIdle()
+    {
+        std::unique_lock<std::mutex> lock(stateMutex_);
+        allDone_.wait(lock, [this]() { return pending_ == 0; });
+    }
+
+    /**
+     * @brief 获取工作线程数
+     * @return 工作线程数
+     */
+    inline size_t size() const
+    {
+        return workers_.size();
+    }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    inline bool tryPop(size_t index, std::function<void()>& task)
+    {
+        // 优先从自己队列的头部取任务
+        {
+            WorkQueue& own = *queues_[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.front());
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+
+        // 从其他队列的尾部窃取
+        for (size_t offset = 1; offset < queues_.size(); ++offset) {
+            WorkQueue& victim = *queues_[(index + offset) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline void workerLoop(size_t index)
+    {
+        while (true) {
+            std::function<void()> task;
+            if (!tryPop(index, task)) {
+                std::unique_lock<std::mutex> lock(stateMutex_);
+                workAvailable_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+                if (stopping_ && queued_ == 0) {
+                    return;
+                }
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(stateMutex_);
+                --queued_;
+            }
+            spaceAvailable_.notify_one();
+
+            try {
+                task();
+            }
+            catch (...) {
+                // 异常由任务自身负责处理，这里只保证工作线程不退出
+            }
+
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            if (--pending_ == 0) {
+                allDone_.notify_all();
+            }
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<WorkQueue>> queues_;  ///< 每个工作线程的任务队列
+    std::vector<std::thread> workers_;                ///< 工作线程
+
+    std::mutex stateMutex_;                     ///< 保护计数与停止标志
+    std::condition_variable workAvailable_;     ///< 有新任务可取
+    std::condition_variable spaceAvailable_;    ///< 队列有空位
+    std::condition_variable allDone_;           ///< 所有任务执行完毕
+
+    size_t capacity_ = 0;                       ///< 排队任务上限
+    size_t queued_ = 0;                         ///< 排队中（未开始执行）的任务数
+    size_t pending_ = 0;                        ///< 排队中与执行中的任务总数
+    size_t nextQueue_ = 0;                      ///< 下一个接收任务的队列序号
+    bool stopping_ = false;                     ///< 是否正在停止
+};
+
+#endif // THREADPOOL_H
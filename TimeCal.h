@@ -1,18 +1,291 @@
+#ifndef TIMECAL_H
+#define TIMECAL_H
+
 #include <chrono>
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include "HistogramBuckets.h"
 
 class TimeCal {
 public:
-    // 使用自动推导的时间点类型
+    // 使用单调时钟，不受系统时间调整影响
     void start() {
-        start_time = std::chrono::high_resolution_clock::now();
+        start_time = std::chrono::steady_clock::now();
     }
 
     double stop() {
-        auto end_time = std::chrono::high_resolution_clock::now();
+        auto end_time = std::chrono::steady_clock::now();
         std::chrono::duration<double> elapsed = end_time - start_time;
         return elapsed.count(); // 返回秒数
     }
 
 private:
-    std::chrono::time_point<std::chrono::high_resolution_clock> start_time;
-};
\ No newline at end of file
+    std::chrono::time_point<std::chrono::steady_clock> start_time;
+};
+
+// 按名称聚合的分段耗时统计
+// 每个线程把耗时记录到自己的统计块中（单写者，只用 relaxed 原子读写，不加锁），
+// 导出时合并所有线程的统计；线程退出时其统计并入已退出线程的汇总
+// 每段记录次数、总耗时、最小/最大值，以及 HDR 风格的对数直方图（桶划分见 HistogramBuckets，相对误差约 6%）
+class Profiler {
+public:
+    static constexpr size_t maxSections = 256;   // 最多可注册的分段数，超出的分段不记录
+
+    // 单个分段的汇总结果，时间单位为纳秒
+    struct SectionReport {
+        std::string name;
+        uint64_t count = 0;
+        uint64_t totalNs = 0;
+        uint64_t minNs = 0;
+        uint64_t maxNs = 0;
+        uint64_t p50Ns = 0;
+        uint64_t p99Ns = 0;
+
+        double meanNs() const {
+            return count ? static_cast<double>(totalNs) / static_cast<double>(count) : 0;
+        }
+    };
+
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    // 注册分段，返回分段编号；同名分段返回同一编号
+    size_t sectionId(const char* name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < names_.size(); ++i) {
+            if (names_[i] == name) return i;
+        }
+        names_.emplace_back(name);
+        return names_.size() - 1;
+    }
+
+    // 记录一次耗时（仅写调用线程自己的统计，不加锁）
+    void record(size_t id, uint64_t ns) {
+        if (id >= maxSections) return;
+        ThreadProfile& profile = threadProfile();
+        SectionStats* stats = profile.sections[id].load(std::memory_order_relaxed);
+        if (!stats) {
+            stats = new SectionStats();
+            profile.sections[id].store(stats, std::memory_order_release);
+        }
+        stats->record(ns);
+    }
+
+    // 合并所有线程的统计，按总耗时从大到小排序
+    std::vector<SectionReport> report() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Totals> totals(retired_);
+        totals.resize(std::min(names_.size(), maxSections));
+        for (const ThreadProfile* profile : live_) {
+            for (size_t i = 0; i < totals.size(); ++i) {
+                const SectionStats* stats = profile->sections[i].load(std::memory_order_acquire);
+                if (stats) stats->mergeInto(totals[i]);
+            }
+        }
+
+        std::vector<SectionReport> reports;
+        for (size_t i = 0; i < totals.size(); ++i) {
+            if (totals[i].count == 0) continue;
+            SectionReport section;
+            section.name = names_[i];
+            section.count = totals[i].count;
+            section.totalNs = totals[i].total;
+            section.minNs = totals[i].min;
+            section.maxNs = totals[i].max;
+            section.p50Ns = std::min(totals[i].percentile(0.50), totals[i].max);
+            section.p99Ns = std::min(totals[i].percentile(0.99), totals[i].max);
+            reports.push_back(std::move(section));
+        }
+        std::sort(reports.begin(), reports.end(), [](const SectionReport& a, const SectionReport& b) {
+            return a.totalNs > b.totalNs;
+        });
+        return reports;
+    }
+
+    // 以文本表格导出
+    std::string dumpText() const {
+        std::string text;
+        char line[512];
+        std::snprintf(line, sizeof(line), "%-40s %10s %12s %10s %10s %10s %10s %10s\n",
+                      "section", "count", "total(ms)", "mean(us)", "min(us)", "p50(us)", "p99(us)", "max(us)");
+        text += line;
+        for (const SectionReport& section : report()) {
+            std::snprintf(line, sizeof(line), "%-40s %10llu %12.3f %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+                          section.name.c_str(), static_cast<unsigned long long>(section.count),
+                          static_cast<double>(section.totalNs) / 1e6, section.meanNs() / 1e3,
+                          static_cast<double>(section.minNs) / 1e3, static_cast<double>(section.p50Ns) / 1e3,
+                          static_cast<double>(section.p99Ns) / 1e3, static_cast<double>(section.maxNs) / 1e3);
+            text += line;
+        }
+        return text;
+    }
+
+    // 以 JSON 导出，时间单位为纳秒
+    std::string dumpJson() const {
+        std::string json = "{\"sections\":[";
+        bool first = true;
+        for (const SectionReport& section : report()) {
+            if (!first) json += ',';
+            first = false;
+            json += "{\"name\":\"";
+            for (char c : section.name) {
+                if (c == '"' || c == '\\') json += '\\';
+                json += c;
+            }
+            json += "\",\"count\":" + std::to_string(section.count)
+                + ",\"total_ns\":" + std::to_string(section.totalNs)
+                + ",\"mean_ns\":" + std::to_string(static_cast<uint64_t>(section.meanNs()))
+                + ",\"min_ns\":" + std::to_string(section.minNs)
+                + ",\"p50_ns\":" + std::to_string(section.p50Ns)
+                + ",\"p99_ns\":" + std::to_string(section.p99Ns)
+                + ",\"max_ns\":" + std::to_string(section.maxNs) + "}";
+        }
+        json += "]}";
+        return json;
+    }
+
+private:
+    static constexpr size_t bucketCount = HistogramBuckets::bucketCount;
+
+    // 合并后的统计（受 mutex_ 保护或为局部变量）
+    struct Totals {
+        uint64_t count = 0;
+        uint64_t total = 0;
+        uint64_t min = std::numeric_limits<uint64_t>::max();
+        uint64_t max = 0;
+        std::vector<uint64_t> buckets = std::vector<uint64_t>(bucketCount, 0);
+
+        uint64_t percentile(double p) const {
+            uint64_t target = static_cast<uint64_t>(p * static_cast<double>(count) + 0.5);
+            if (target == 0) target = 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < buckets.size(); ++i) {
+                seen += buckets[i];
+                if (seen >= target) return HistogramBuckets::midpoint(i);
+            }
+            return max;
+        }
+    };
+
+    // 单个线程中一个分段的统计，只由所属线程写入
+    struct SectionStats {
+        std::atomic<uint64_t> count{ 0 };
+        std::atomic<uint64_t> total{ 0 };
+        std::atomic<uint64_t> min{ std::numeric_limits<uint64_t>::max() };
+        std::atomic<uint64_t> max{ 0 };
+        std::array<std::atomic<uint64_t>, bucketCount> buckets{};
+
+        static void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        void record(uint64_t ns) {
+            bump(count, 1);
+            bump(total, ns);
+            if (ns < min.load(std::memory_order_relaxed)) min.store(ns, std::memory_order_relaxed);
+            if (ns > max.load(std::memory_order_relaxed)) max.store(ns, std::memory_order_relaxed);
+            bump(buckets[HistogramBuckets::index(ns)], 1);
+        }
+
+        void mergeInto(Totals& totals) const {
+            uint64_t n = count.load(std::memory_order_relaxed);
+            if (n == 0) return;
+            totals.count += n;
+            totals.total += total.load(std::memory_order_relaxed);
+            totals.min = std::min(totals.min, min.load(std::memory_order_relaxed));
+            totals.max = std::max(totals.max, max.load(std::memory_order_relaxed));
+            for (size_t i = 0; i < bucketCount; ++i) {
+                totals.buckets[i] += buckets[i].load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // 每个线程的统计块，线程退出时并入 retired_
+    struct ThreadProfile {
+        std::array<std::atomic<SectionStats*>, maxSections> sections{};
+
+        ThreadProfile() {
+            Profiler& profiler = Profiler::instance();
+            std::lock_guard<std::mutex> lock(profiler.mutex_);
+            profiler.live_.push_back(this);
+        }
+
+        ~ThreadProfile() {
+            Profiler& profiler = Profiler::instance();
+            std::lock_guard<std::mutex> lock(profiler.mutex_);
+            profiler.live_.erase(std::remove(profiler.live_.begin(), profiler.live_.end(), this), profiler.live_.end());
+            for (size_t i = 0; i < maxSections; ++i) {
+                SectionStats* stats = sections[i].load(std::memory_order_relaxed);
+                if (!stats) continue;
+                if (profiler.retired_.size() <= i) profiler.retired_.resize(i + 1);
+                stats->mergeInto(profiler.retired_[i]);
+                delete stats;
+            }
+        }
+    };
+
+    static ThreadProfile& threadProfile() {
+        thread_local ThreadProfile profile;
+        return profile;
+    }
+
+    Profiler() = default;
+
+    mutable std::mutex mutex_;              // 保护以下成员
+    std::vector<std::string> names_;        // 分段名称，下标即分段编号
+    std::vector<ThreadProfile*> live_;      // 仍在运行的线程的统计块
+    std::vector<Totals> retired_;           // 已退出线程的汇总
+};
+
+// 已注册的分段，通常以函数内的静态变量保存，只在首次执行时注册
+class ProfileSection {
+public:
+    explicit ProfileSection(const char* name) : id(Profiler::instance().sectionId(name)) {}
+
+    size_t id;
+};
+
+// 作用域计时器，析构时把耗时记录到分段
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const ProfileSection& section)
+        : section_id(section.id), start_time(std::chrono::steady_clock::now()) {}
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start_time;
+        Profiler::instance().record(section_id,
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+private:
+    size_t section_id;
+    std::chrono::time_point<std::chrono::steady_clock> start_time;
+};
+
+// 统计所在作用域的耗时：定义 HEADONLY_ENABLE_PROFILING 时生效，否则不产生任何代码
+// 用法：HEADONLY_PROFILE_SCOPE("EncodingConverter::detect");
+#define HEADONLY_PROFILE_CONCAT_INNER(a, b) a##b
+#define HEADONLY_PROFILE_CONCAT(a, b) HEADONLY_PROFILE_CONCAT_INNER(a, b)
+#ifdef HEADONLY_ENABLE_PROFILING
+#define HEADONLY_PROFILE_SCOPE(name) \
+    static const ProfileSection HEADONLY_PROFILE_CONCAT(headonlyProfileSection_, __LINE__)(name); \
+    ScopedTimer HEADONLY_PROFILE_CONCAT(headonlyProfileTimer_, __LINE__)(HEADONLY_PROFILE_CONCAT(headonlyProfileSection_, __LINE__))
+#else
+#define HEADONLY_PROFILE_SCOPE(name) ((void)0)
+#endif
+
+#endif // TIMECAL_H
@@ -1,24 +1,121 @@
+#ifndef TIMER_H
+#define TIMER_H
+
 #include <thread>
 #include <functional>
 #include <chrono>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <type_traits>
+#include <cstring>
+
+#include "HistogramBuckets.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
 
 class Timer {
 public:
+    // 等待方式
+    enum class WaitMode {
+        Sleep,      // 只使用 sleep_until（默认），精度受系统调度影响
+        Precision   // 先 sleep_until 到截止时间前的自旋阈值，再忙等到截止时间，适合微秒级间隔
+    };
+
+    // 任务执行超时（错过一个或多个触发时间点）时的处理方式
+    enum class OverrunPolicy {
+        CatchUp,    // 立即连续补执行错过的次数（默认）
+        Skip,       // 跳过错过的次数，下一次在原时间网格上的下一个时间点执行
+        Report      // 同 Skip，并通过回调报告错过的次数
+    };
+
+    // 统计快照，时长单位为纳秒；分位数为近似值（相对误差约 6%）
+    struct Statistics {
+        uint64_t ticks = 0;             // 已执行的次数
+        uint64_t overruns = 0;          // 任务执行结束时已超过下一个触发时间点的次数
+        uint64_t missedTicks = 0;       // 按 Skip/Report 策略跳过的触发次数
+        int64_t latenessP50 = 0;        // 触发延迟（实际执行时间与预定时间点之差）
+        int64_t latenessP99 = 0;
+        int64_t latenessMax = 0;
+        int64_t executionP50 = 0;       // 任务执行耗时
+        int64_t executionP99 = 0;
+        int64_t executionMax = 0;
+        int64_t executionMean = 0;
+    };
+
     Timer() : m_running(false) {}
 
+    // 启用或关闭统计，需在启动前调用；启用后在定时器线程中无锁记录，statistics() 可在任意线程读取
+    void setStatisticsEnabled(bool enabled) {
+        m_statisticsEnabled = enabled;
+    }
+
+    // 获取统计快照（未启用统计时全部为 0）
+    Statistics statistics() const {
+        Statistics stats;
+        stats.ticks = m_ticks.load(std::memory_order_relaxed);
+        stats.overruns = m_overruns.load(std::memory_order_relaxed);
+        stats.missedTicks = m_missedTicks.load(std::memory_order_relaxed);
+        stats.latenessP50 = m_lateness.percentile(0.50);
+        stats.latenessP99 = m_lateness.percentile(0.99);
+        stats.latenessMax = m_lateness.max();
+        stats.executionP50 = m_execution.percentile(0.50);
+        stats.executionP99 = m_execution.percentile(0.99);
+        stats.executionMax = m_execution.max();
+        stats.executionMean = stats.ticks ? static_cast<int64_t>(m_executionTotal.load(std::memory_order_relaxed) / stats.ticks) : 0;
+        return stats;
+    }
+
+    // 设置等待方式，需在启动前调用
+    // spinThreshold 为 Precision 模式下截止时间前开始忙等的时长，应大于系统调度抖动
+    void setWaitMode(WaitMode mode, std::chrono::nanoseconds spinThreshold = std::chrono::microseconds(200)) {
+        m_waitMode = mode;
+        m_spinThreshold = spinThreshold;
+    }
+
+    // 设置超时处理方式，需在启动前调用
+    // onOverrun 在 Report 模式下于定时器线程中调用，参数为本次错过的触发次数
+    void setOverrunPolicy(OverrunPolicy policy, std::function<void(uint64_t missed)> onOverrun = nullptr) {
+        m_overrunPolicy = policy;
+        m_onOverrun = std::move(onOverrun);
+    }
+
+    // 将定时器线程绑定到指定 CPU 核心，需在启动前调用；core 为负时不绑定（默认），仅 Linux 有效
+    void setCpuAffinity(int core) {
+        m_cpuCore = core;
+    }
+
+    // 以 SCHED_FIFO 实时调度策略运行定时器线程，需在启动前调用；priority 为 0 时使用普通调度（默认）
+    // 通常需要 CAP_SYS_NICE 权限，设置失败时输出警告并以普通调度继续运行，仅 Linux 有效
+    void setRealtimePriority(int priority) {
+        m_realtimePriority = priority;
+    }
+
     // 启动定时器，以毫秒级别为间隔执行任务
-    void startMilliseconds(int64_t intervalMs, std::function<void()> task) {
-        start<std::chrono::milliseconds>(intervalMs, task);
+    // task 可以是任意可调用对象（包括只能移动的对象），被移动到定时器线程中直接调用，不做类型擦除
+    template <typename Task>
+    void startMilliseconds(int64_t intervalMs, Task&& task) {
+        start<std::chrono::milliseconds>(intervalMs, std::forward<Task>(task));
     }
 
-    // 纳秒级别的定时器接口
-    void startMicroseconds(int64_t intervalNs, std::function<void()> task) {
-        start<std::chrono::microseconds>(intervalNs, task);
+    // 微秒级别的定时器接口
+    template <typename Task>
+    void startMicroseconds(int64_t intervalUs, Task&& task) {
+        start<std::chrono::microseconds>(intervalUs, std::forward<Task>(task));
     }
 
     // 纳秒级别的定时器接口
-    void startNanoseconds(int64_t intervalNs, std::function<void()> task) {
-        start<std::chrono::nanoseconds>(intervalNs, task);
+    template <typename Task>
+    void startNanoseconds(int64_t intervalNs, Task&& task) {
+        start<std::chrono::nanoseconds>(intervalNs, std::forward<Task>(task));
     }
 
     // 停止定时器
@@ -37,25 +134,176 @@ private:
     std::thread m_thread;         // 定时器线程
     std::atomic<bool> m_running;  // 用于控制定时器的状态
 
+    WaitMode m_waitMode = WaitMode::Sleep;                              // 等待方式
+    std::chrono::nanoseconds m_spinThreshold = std::chrono::microseconds(200);  // 自旋阈值
+    OverrunPolicy m_overrunPolicy = OverrunPolicy::CatchUp;             // 超时处理方式
+    std::function<void(uint64_t)> m_onOverrun;                          // 超时报告回调
+    int m_cpuCore = -1;                                                 // 绑定的 CPU 核心，负数表示不绑定
+    int m_realtimePriority = 0;                                         // 实时调度优先级，0 表示普通调度
+
+    // 纳秒时长的对数直方图，桶划分见 HistogramBuckets（每个 2 的幂区间 16 个子桶）
+    // 只由定时器线程写入（单写者，使用 load + store 而非原子读改写），其他线程可随时读取
+    class Histogram {
+    public:
+        void record(int64_t ns) {
+            if (ns < 0) ns = 0;
+            auto& bucket = m_buckets[HistogramBuckets::index(static_cast<uint64_t>(ns))];
+            bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            m_count.store(m_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            if (ns > m_max.load(std::memory_order_relaxed)) {
+                m_max.store(ns, std::memory_order_relaxed);
+            }
+        }
+
+        // 返回分位数所在区间的上界
+        int64_t percentile(double p) const {
+            uint64_t count = m_count.load(std::memory_order_relaxed);
+            if (count == 0) return 0;
+            uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(count - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < bucketCount; ++i) {
+                seen += m_buckets[i].load(std::memory_order_relaxed);
+                if (seen >= rank) {
+                    int64_t upper = static_cast<int64_t>(HistogramBuckets::upperBound(i));
+                    int64_t max = m_max.load(std::memory_order_relaxed);
+                    return upper < max ? upper : max;
+                }
+            }
+            return m_max.load(std::memory_order_relaxed);
+        }
+
+        int64_t max() const {
+            return m_max.load(std::memory_order_relaxed);
+        }
+
+    private:
+        static constexpr size_t bucketCount = HistogramBuckets::bucketCount;
+
+        std::atomic<uint64_t> m_buckets[bucketCount] = {};
+        std::atomic<uint64_t> m_count{ 0 };
+        std::atomic<int64_t> m_max{ 0 };
+    };
+
+    bool m_statisticsEnabled = false;            // 是否记录统计
+    std::atomic<uint64_t> m_ticks{ 0 };          // 已执行次数
+    std::atomic<uint64_t> m_overruns{ 0 };       // 超时次数
+    std::atomic<uint64_t> m_missedTicks{ 0 };    // 跳过的触发次数
+    std::atomic<uint64_t> m_executionTotal{ 0 }; // 任务总耗时（纳秒）
+    Histogram m_lateness;                        // 触发延迟分布
+    Histogram m_execution;                       // 任务耗时分布
+
+    // 单写者递增计数
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    // 忙等时让出流水线资源，降低功耗并避免影响同核的超线程
+    static void cpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    // 在定时器线程中应用 CPU 绑定与调度策略
+    void configureThread() {
+#ifdef __linux__
+        if (m_cpuCore >= 0) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(m_cpuCore, &cpus);
+            int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+            if (error != 0) {
+                std::cerr << "Timer: failed to pin thread to CPU " << m_cpuCore << ": " << std::strerror(error) << std::endl;
+            }
+        }
+        if (m_realtimePriority > 0) {
+            sched_param param{};
+            param.sched_priority = m_realtimePriority;
+            int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+            if (error != 0) {
+                std::cerr << "Timer: failed to set realtime priority " << m_realtimePriority << ": " << std::strerror(error) << std::endl;
+            }
+        }
+#else
+        if (m_cpuCore >= 0 || m_realtimePriority > 0) {
+            std::cerr << "Timer: CPU affinity and realtime priority are only supported on Linux" << std::endl;
+        }
+#endif
+    }
+
+    // 等待到指定时间点
+    void waitUntil(std::chrono::steady_clock::time_point deadline) {
+        if (m_waitMode == WaitMode::Sleep) {
+            std::this_thread::sleep_until(deadline);
+            return;
+        }
+
+        auto sleepDeadline = deadline - m_spinThreshold;
+        if (std::chrono::steady_clock::now() < sleepDeadline) {
+            std::this_thread::sleep_until(sleepDeadline);
+        }
+        while (std::chrono::steady_clock::now() < deadline && m_running) {
+            cpuRelax();
+        }
+    }
+
     // 通用的定时器实现函数，使用模板参数来适应不同时间单位
-    template<typename DurationType>
-    void start(int64_t interval, std::function<void()> task) {
+    template<typename DurationType, typename Task>
+    void start(int64_t interval, Task&& task) {
         if (m_running) {
             std::cout << "Timer is already running!" << std::endl;
             return;
         }
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
 
         m_running = true;
-        m_thread = std::thread([=]() {
-            auto next_time = std::chrono::steady_clock::now() + DurationType(interval);
+        m_thread = std::thread([this, interval, task = std::decay_t<Task>(std::forward<Task>(task))]() mutable {
+            configureThread();
+            const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(DurationType(interval));
+            // 时间点按固定网格累加，不受任务耗时影响，因此不会漂移
+            auto next_time = std::chrono::steady_clock::now() + period;
             while (m_running) {
-                std::this_thread::sleep_until(next_time);
-                next_time += DurationType(interval);  // 下次执行的时间点
+                waitUntil(next_time);
+                const auto scheduled = next_time;
+                next_time += period;  // 下次执行的时间点
+
+                if (!m_running) {
+                    break;
+                }
 
-                if (m_running) {
+                if (m_statisticsEnabled) {
+                    auto begin = std::chrono::steady_clock::now();
+                    task();  // 每隔指定的时间执行任务
+                    auto end = std::chrono::steady_clock::now();
+                    int64_t execution = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+                    m_lateness.record(std::chrono::duration_cast<std::chrono::nanoseconds>(begin - scheduled).count());
+                    m_execution.record(execution);
+                    bump(m_executionTotal, static_cast<uint64_t>(execution));
+                    bump(m_ticks);
+                } else {
                     task();  // 每隔指定的时间执行任务
                 }
+
+                auto now = std::chrono::steady_clock::now();
+                if (now >= next_time) {
+                    if (m_statisticsEnabled) bump(m_overruns);
+                    if (m_overrunPolicy != OverrunPolicy::CatchUp && period.count() > 0) {
+                        // 任务超时，跳过已错过的时间点
+                        uint64_t missed = static_cast<uint64_t>((now - next_time) / period) + 1;
+                        next_time += period * static_cast<int64_t>(missed);
+                        if (m_statisticsEnabled) bump(m_missedTicks, missed);
+                        if (m_overrunPolicy == OverrunPolicy::Report && m_onOverrun) {
+                            m_onOverrun(missed);
+                        }
+                    }
+                }
             }
         });
     }
-};
\ No newline at end of file
+};
+
+#endif // TIMER_H
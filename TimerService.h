@@ -0,0 +1,324 @@
+#ifndef TIMERSERVICE_H
+#define TIMERSERVICE_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <deque>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+// 多个定时器共享一个线程的定时服务
+// 基于分层时间轮（4 层，每层 256 个槽）：添加与取消均为 O(1)，每个时间刻度只处理到期的槽，
+// 因此数千个周期或一次性定时器只需一个线程，避免每个 Timer 独占线程带来的上下文切换开销
+// 回调在服务线程中依次执行，耗时的工作应转交给线程池
+class TimerService {
+public:
+    // 定时器句柄，用于取消定时器；定时器结束后句柄自动失效，不会误取消复用同一存储的新定时器
+    class Handle {
+    public:
+        Handle() = default;
+
+        bool valid() const {
+            return m_index != invalidIndex;
+        }
+
+    private:
+        friend class TimerService;
+        static constexpr uint32_t invalidIndex = UINT32_MAX;
+
+        Handle(uint32_t index, uint32_t generation) : m_index(index), m_generation(generation) {}
+
+        uint32_t m_index = invalidIndex;   // 定时器存储序号
+        uint32_t m_generation = 0;         // 存储复用代数
+    };
+
+    // 构造并启动服务线程
+    // tick 为时间轮刻度，即定时精度，默认 1 毫秒
+    explicit TimerService(std::chrono::nanoseconds tick = std::chrono::milliseconds(1))
+        : m_tick(tick.count() > 0 ? tick : std::chrono::nanoseconds(1)),
+        m_start(std::chrono::steady_clock::now()) {
+        m_thread = std::thread([this]() { run(); });
+    }
+
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    ~TimerService() {
+        stop();
+    }
+
+    // 添加一次性定时器，delay 后执行 task；到期时间向上取整到刻度，不会早于 delay 执行
+    Handle scheduleOnce(std::chrono::nanoseconds delay, std::function<void()> task) {
+        return schedule(delay, std::chrono::nanoseconds(0), std::move(task));
+    }
+
+    // 添加周期定时器，首次在 initialDelay（为负时取 interval）后执行，之后每隔 interval 执行
+    // 执行时间点按固定网格累加，不会漂移；服务线程落后时跳过已错过的时间点而不是连续补执行
+    // 周期以刻度为单位：不是刻度整数倍时向上取整，不足一个刻度时按一个刻度，因此实际周期不会短于 interval
+    Handle schedulePeriodic(std::chrono::nanoseconds interval, std::function<void()> task,
+                            std::chrono::nanoseconds initialDelay = std::chrono::nanoseconds(-1)) {
+        if (interval < m_tick) interval = m_tick;
+        return schedule(initialDelay.count() < 0 ? interval : initialDelay, interval, std::move(task));
+    }
+
+    // 取消定时器，成功返回 true；定时器已结束或句柄无效时返回 false
+    // 回调正在执行时取消不会中断本次执行，但周期定时器不会再次执行
+    bool cancel(Handle handle) {
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (handle.m_index >= m_nodes.size()) return false;
+            Node& node = m_nodes[handle.m_index];
+            if (node.generation != handle.m_generation) return false;
+
+            if (node.state == State::Scheduled) {
+                unlink(node);
+                task = std::move(node.task);
+                release(node);
+                return true;
+            }
+            if (node.state == State::Running) {
+                node.state = State::Cancelled;
+                return true;
+            }
+            return false;
+        }
+    }
+
+    // 当前未结束的定时器数量
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_active;
+    }
+
+    // 停止服务线程，未到期的定时器不再执行
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+private:
+    static constexpr int levelBits = 8;
+    static constexpr uint64_t slotCount = 1u << levelBits;
+    static constexpr uint64_t slotMask = slotCount - 1;
+    static constexpr int levelCount = 4;
+
+    enum class State : uint8_t { Free, Scheduled, Running, Cancelled };
+
+    struct Node {
+        Node* prev = nullptr;
+        Node* next = nullptr;
+        uint64_t expiry = 0;           // 到期刻度
+        uint64_t interval = 0;         // 周期（刻度数），0 表示一次性
+        uint32_t index = 0;            // 在 m_nodes 中的序号
+        uint32_t generation = 0;       // 存储复用代数
+        uint8_t level = 0;             // 所在层
+        uint8_t slot = 0;              // 所在槽
+        State state = State::Free;
+        std::function<void()> task;
+    };
+
+    Handle schedule(std::chrono::nanoseconds delay, std::chrono::nanoseconds interval, std::function<void()> task) {
+        if (delay.count() < 0) delay = std::chrono::nanoseconds(0);
+        bool wasIdle = false;
+        Handle handle;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto sinceStart = std::chrono::steady_clock::now() - m_start;
+            if (m_active == 0) {
+                // 空闲期间服务线程不推进刻度，时间轮为空，直接跳到当前刻度
+                uint64_t nowTick = static_cast<uint64_t>(sinceStart / m_tick);
+                if (nowTick > m_currentTick) m_currentTick = nowTick;
+            }
+
+            Node& node = acquire();
+            // 向上取整，保证不早于 delay 执行
+            auto elapsed = sinceStart + delay;
+            uint64_t expiry = static_cast<uint64_t>((elapsed + m_tick - std::chrono::nanoseconds(1)) / m_tick);
+            node.expiry = expiry < m_currentTick ? m_currentTick : expiry;
+            // 周期向上取整到刻度（schedulePeriodic 已保证至少一个刻度），0 表示一次性
+            node.interval = interval.count() > 0
+                ? static_cast<uint64_t>((interval + m_tick - std::chrono::nanoseconds(1)) / m_tick)
+                : 0;
+            node.task = std::move(task);
+            node.state = State::Scheduled;
+            wasIdle = m_active++ == 0;
+            insert(node);
+            handle = Handle(node.index, node.generation);
+        }
+        if (wasIdle) {
+            m_wake.notify_one();
+        }
+        return handle;
+    }
+
+    // 从空闲链表取出一个存储，没有时追加（std::deque 追加不会使已有元素的引用失效）
+    Node& acquire() {
+        if (!m_freeList.empty()) {
+            Node& node = m_nodes[m_freeList.back()];
+            m_freeList.pop_back();
+            return node;
+        }
+        m_nodes.emplace_back();
+        Node& node = m_nodes.back();
+        node.index = static_cast<uint32_t>(m_nodes.size() - 1);
+        return node;
+    }
+
+    void release(Node& node) {
+        node.state = State::Free;
+        ++node.generation;
+        --m_active;
+        m_freeList.push_back(node.index);
+    }
+
+    // 按到期刻度与当前刻度的距离放入对应层的槽
+    void insert(Node& node) {
+        uint64_t delta = node.expiry - m_currentTick;
+        int level = 0;
+        while (level < levelCount - 1 && delta >= (uint64_t(1) << (levelBits * (level + 1)))) {
+            ++level;
+        }
+        uint64_t slot;
+        if (level == levelCount - 1 && delta >= (uint64_t(1) << (levelBits * levelCount))) {
+            // 超出时间轮范围，放入最高层最远的槽，级联时重新计算位置
+            slot = ((m_currentTick >> (levelBits * level)) + slotMask) & slotMask;
+        } else {
+            slot = (node.expiry >> (levelBits * level)) & slotMask;
+        }
+
+        node.level = static_cast<uint8_t>(level);
+        node.slot = static_cast<uint8_t>(slot);
+        Node*& head = m_wheel[level][slot];
+        node.prev = nullptr;
+        node.next = head;
+        if (head) head->prev = &node;
+        head = &node;
+        node.state = State::Scheduled;
+    }
+
+    void unlink(Node& node) {
+        if (node.prev) {
+            node.prev->next = node.next;
+        } else {
+            m_wheel[node.level][node.slot] = node.next;
+        }
+        if (node.next) node.next->prev = node.prev;
+        node.prev = node.next = nullptr;
+    }
+
+    // 把高层槽中的定时器按新的当前刻度重新放置
+    void cascade(int level, uint64_t slot) {
+        Node* node = m_wheel[level][slot];
+        m_wheel[level][slot] = nullptr;
+        while (node) {
+            Node* next = node->next;
+            insert(*node);
+            node = next;
+        }
+    }
+
+    // 处理当前刻度：级联高层槽，取出到期的定时器
+    void advance() {
+        const uint64_t tick = m_currentTick;
+        for (int level = levelCount - 1; level >= 1; --level) {
+            if ((tick & ((uint64_t(1) << (levelBits * level)) - 1)) == 0) {
+                cascade(level, (tick >> (levelBits * level)) & slotMask);
+            }
+        }
+
+        Node* node = m_wheel[0][tick & slotMask];
+        m_wheel[0][tick & slotMask] = nullptr;
+        while (node) {
+            Node* next = node->next;
+            node->prev = node->next = nullptr;
+            node->state = State::Running;
+            m_expired.push_back(node);
+            node = next;
+        }
+        ++m_currentTick;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stopping) {
+            if (m_active == 0) {
+                // 没有定时器时不空转，等待新的定时器或停止
+                m_wake.wait(lock, [this]() { return m_stopping || m_active > 0; });
+                continue;
+            }
+
+            auto deadline = m_start + m_tick * m_currentTick;
+            if (std::chrono::steady_clock::now() < deadline) {
+                m_wake.wait_until(lock, deadline, [this]() { return m_stopping; });
+                continue;
+            }
+
+            advance();
+            if (m_expired.empty()) continue;
+
+            // 回调在锁外执行，回调中可以添加或取消定时器
+            lock.unlock();
+            for (Node* node : m_expired) {
+                try {
+                    node->task();
+                }
+                catch (...) {
+                    // 异常由回调自身负责处理，这里只保证服务线程不退出
+                }
+            }
+            lock.lock();
+
+            std::vector<std::function<void()>> finished;
+            for (Node* node : m_expired) {
+                if (node->state == State::Running && node->interval > 0 && !m_stopping) {
+                    node->expiry += node->interval;
+                    if (node->expiry < m_currentTick) {
+                        uint64_t behind = m_currentTick - node->expiry;
+                        node->expiry += (behind + node->interval - 1) / node->interval * node->interval;
+                    }
+                    insert(*node);
+                } else {
+                    finished.push_back(std::move(node->task));
+                    release(*node);
+                }
+            }
+            m_expired.clear();
+            if (!finished.empty()) {
+                // 在锁外析构回调，避免其捕获对象的析构函数访问本服务时死锁
+                lock.unlock();
+                finished.clear();
+                lock.lock();
+            }
+        }
+    }
+
+private:
+    const std::chrono::nanoseconds m_tick;                   // 时间轮刻度
+    const std::chrono::steady_clock::time_point m_start;     // 第 0 个刻度的时间点
+
+    mutable std::mutex m_mutex;                              // 保护以下所有状态
+    std::condition_variable m_wake;                          // 唤醒服务线程
+    std::deque<Node> m_nodes;                                // 定时器存储
+    std::vector<uint32_t> m_freeList;                        // 空闲存储序号
+    std::array<std::array<Node*, slotCount>, levelCount> m_wheel{};  // 各层的槽（双向链表头）
+    std::vector<Node*> m_expired;                            // 当前刻度到期的定时器
+    uint64_t m_currentTick = 0;                              // 下一个要处理的刻度
+    size_t m_active = 0;                                     // 未结束的定时器数量
+    bool m_stopping = false;                                 // 是否正在停止
+
+    std::thread m_thread;                                    // 服务线程
+};
+
+#endif // TIMERSERVICE_H
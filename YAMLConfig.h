@@ -6,30 +6,244 @@
 #include <unordered_map>
 #include <vector>
 #include <stdexcept>
+#include <memory>
+#include <atomic>
+#include <array>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <limits>
+#include <type_traits>
+#include <filesystem>
+#include <functional>
+#include <sstream>
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
 
 class YAMLConfig {
 public:
+    // 类型化的配置句柄：获取时查找并转换一次，之后每次读取只需比较一次版本号，配置变化后自动重新查找
+    // 句柄不是线程安全的，每个线程应持有自己的句柄；句柄不能比所属的 YAMLConfig 存活更久
+    template <typename T>
+    class Handle {
+    public:
+        const T& get() {
+            uint64_t version = config_->version_.load(std::memory_order_acquire);
+            if (version != version_) {
+                refresh();
+            }
+            return value_;
+        }
+
+        const T& operator*() {
+            return get();
+        }
+
+        const T* operator->() {
+            return &get();
+        }
+
+        const std::string& key() const {
+            return key_;
+        }
+
+    private:
+        friend class YAMLConfig;
+
+        Handle(const YAMLConfig* config, std::string key) : config_(config), key_(std::move(key)) {
+            refresh();
+        }
+
+        void refresh() {
+            const Snapshot& snapshot = config_->currentSnapshot();
+            value_ = config_->find(snapshot, key_).template as<T>();
+            version_ = snapshot.version;
+        }
+
+        const YAMLConfig* config_;
+        std::string key_;
+        uint64_t version_ = 0;
+        T value_{};
+    };
+
     // 构造函数，指定配置文件路径
-    YAMLConfig(const std::string& filename) : filename_(filename) {
+    // flushDelay 为写入后延迟保存的时间：期间的多次写入合并为一次保存
+    YAMLConfig(const std::string& filename, std::chrono::milliseconds flushDelay = std::chrono::milliseconds(200))
+        : filename_(filename), flushDelay_(flushDelay), id_(nextInstanceId()) {
         load();
+        flusher_ = std::thread([this]() { flushLoop(); });
+    }
+
+    YAMLConfig(const YAMLConfig&) = delete;
+    YAMLConfig& operator=(const YAMLConfig&) = delete;
+
+    // 析构时保存尚未写入文件的修改
+    ~YAMLConfig() {
+        disableHotReload();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        flushCondition_.notify_all();
+        if (flusher_.joinable()) {
+            flusher_.join();
+        }
     }
 
     // 读取配置文件中的指定键值，返回类型为 T
+    // key 可以是以 '.' 分隔的路径（如 "server.pool.size"），加载时所有嵌套映射已展开为扁平索引
+    // 键名本身含 '.' 或 '\' 时用 "\." 与 "\\" 转义（如顶层键 "a.b" 写作 a\.b，C++ 字面量为 "a\\.b"），与嵌套路径 a → b 互不冲突；
+    // 为兼容旧的配置文件，不存在同名嵌套路径时，未转义的 "a.b" 也能读到顶层键 "a.b"
+    // 读取不加锁：从原子替换的只读快照中取值，整数、浮点、布尔与字符串在加载时即已转换
     template <typename T>
-    T read(const std::string& key) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (!config_[key]) {
-            throw std::runtime_error("Key '" + key + "' not found in config file.");
-        }
-        return config_[key].as<T>();
+    T read(const std::string& key) const {
+        return find(currentSnapshot(), key).template as<T>();
+    }
+
+    // 获取指定键的类型化句柄，键不存在或转换失败时抛出与 read 相同的异常
+    template <typename T>
+    Handle<T> handle(const std::string& key) const {
+        return Handle<T>(this, key);
     }
 
-    // 写入配置文件中的指定键值
+    // 写入配置文件中的指定键值，key 的写法与 read 相同，不存在的中间映射会被创建
+    // 写入立即对 read 可见；文件在最后一次写入 flushDelay 后由后台线程保存（临时文件加重命名）
+    // 新快照与上一个快照共享未修改的部分：只复制被修改的索引分片（共约 4√N 片，N 为键与映射总数），
+    // 各级父映射只替换路径上的子值（O(深度 × 映射大小)），再索引被写入的值；不再复制整个索引或深拷贝父映射
     template <typename T>
     void write(const std::string& key, const T& value) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        config_[key] = value;
-        save();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::vector<std::string> path = splitForWrite(key);
+            YAML::Node node = config_;
+            for (const auto& part : path) {
+                node.reset(node[part]);
+            }
+            node = value;
+
+            SnapshotBuilder builder(*std::atomic_load(&snapshot_));
+            reindex(builder, path);
+            publish(builder.finish());
+
+            dirty_ = true;
+            lastWrite_ = std::chrono::steady_clock::now();
+        }
+        flushCondition_.notify_one();
+    }
+
+    // 立即保存尚未写入文件的修改，失败时抛出异常
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        saveLocked(lock);
+    }
+
+    // 配置变化回调，参数为订阅的键
+    using ChangeCallback = std::function<void(const std::string&)>;
+
+    // 订阅指定键（可以是路径，订阅映射时其下任意值变化都会通知）的变化，返回订阅编号
+    // 回调在重新加载的线程（热加载时为监视线程）中、新快照发布之后执行，本进程的 write 不触发回调
+    size_t subscribe(const std::string& key, ChangeCallback callback) {
+        std::lock_guard<std::mutex> lock(subscribersMutex_);
+        size_t id = ++nextSubscriptionId_;
+        subscribers_.push_back(std::make_shared<Subscription>(Subscription{ id, key, std::move(callback) }));
+        return id;
+    }
+
+    // 取消订阅；正在执行的回调不受影响
+    void unsubscribe(size_t id) {
+        std::lock_guard<std::mutex> lock(subscribersMutex_);
+        for (auto it = subscribers_.begin(); it != subscribers_.end(); ++it) {
+            if ((*it)->id == id) {
+                subscribers_.erase(it);
+                return;
+            }
+        }
+    }
+
+    // 重新读取配置文件，文件内容与当前加载的不同时重新解析并原子替换快照，返回是否发生替换
+    // 解析在调用线程中进行，不阻塞 read；文件解析失败时保留原配置
+    // 注：外部修改优先，尚未保存的 write 会被丢弃
+    bool reload() {
+        std::lock_guard<std::mutex> saveLock(saveMutex_);
+        std::string content;
+        try {
+            content = readFileContent(filename_);
+        } catch (const std::exception& e) {
+            std::cerr << "Error reloading YAML file: " << e.what() << std::endl;
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (content == fileContent_) return false;
+        }
+
+        YAML::Node parsed;
+        try {
+            parsed = YAML::Load(content);
+        } catch (const YAML::Exception& e) {
+            std::cerr << "Error reloading YAML file: " << e.what() << std::endl;
+            return false;
+        }
+        std::shared_ptr<Snapshot> snapshot = buildSnapshot(parsed);
+
+        std::shared_ptr<const Snapshot> previous;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (dirty_) {
+                std::cerr << "YAML file changed externally, discarding unsaved changes: " << filename_ << std::endl;
+                dirty_ = false;
+            }
+            config_ = parsed;
+            fileContent_ = std::move(content);
+            previous = std::atomic_load(&snapshot_);
+            publish(snapshot);
+        }
+        notifySubscribers(*previous, *snapshot);
+        return true;
+    }
+
+    // 开启热加载：配置文件被修改后由监视线程自动调用 reload
+    // Linux 使用 inotify 监视文件所在目录（兼容编辑器先写临时文件再重命名的保存方式），
+    // 其他平台或 inotify 不可用时每 pollInterval 检查一次文件的修改时间与大小
+    void enableHotReload(std::chrono::milliseconds pollInterval = std::chrono::milliseconds(1000)) {
+        std::lock_guard<std::mutex> lock(watchMutex_);
+        if (watcher_.joinable()) return;
+        watchStopping_ = false;
+#ifdef __linux__
+        wakeFd_ = eventfd(0, EFD_CLOEXEC);
+#endif
+        watcher_ = std::thread([this, pollInterval]() { watchLoop(pollInterval); });
+    }
+
+    // 关闭热加载
+    void disableHotReload() {
+        std::lock_guard<std::mutex> lock(watchMutex_);
+        if (!watcher_.joinable()) return;
+        {
+            std::lock_guard<std::mutex> stopLock(watchStopMutex_);
+            watchStopping_ = true;
+        }
+        watchCondition_.notify_all();
+#ifdef __linux__
+        if (wakeFd_ >= 0) {
+            uint64_t one = 1;
+            ssize_t written = ::write(wakeFd_, &one, sizeof(one));
+            (void)written;
+        }
+#endif
+        watcher_.join();
+#ifdef __linux__
+        if (wakeFd_ >= 0) {
+            ::close(wakeFd_);
+            wakeFd_ = -1;
+        }
+#endif
     }
 
     // 读取整个配置文件并打印（调试用）
@@ -39,27 +253,607 @@ public:
     }
 
 private:
+    // 单个配置值：深拷贝的节点与预先转换好的标量
+    // 映射只保存各子值（与快照索引中的子项为同一对象），节点在第一次需要时由子值拼出，
+    // 因此写入时父映射只需替换一个子值，不必深拷贝整个子树；未变化的子树在新旧快照之间共享
+    class Value {
+    public:
+        // 映射项：转义后的路径段与子值
+        using Child = std::pair<std::string, std::shared_ptr<const Value>>;
+
+        // 映射，节点按需拼出
+        explicit Value(std::vector<Child> children)
+            : children_(std::move(children)), isMap_(true), lazy_(true) {
+        }
+
+        // 其他节点（以及键不全是标量的映射）：保存深拷贝的节点，children 为其中已索引的子值
+        explicit Value(YAML::Node node, std::vector<Child> children = {})
+            : node_(std::move(node)), children_(std::move(children)), isMap_(node_.IsMap()), isScalar_(node_.IsScalar()) {
+            if (!isScalar_) return;
+            text_ = node_.Scalar();
+            hasInt_ = YAML::convert<long long>::decode(node_, intValue_);
+            hasUInt_ = YAML::convert<unsigned long long>::decode(node_, uintValue_);
+            hasDouble_ = YAML::convert<double>::decode(node_, doubleValue_);
+            hasBool_ = YAML::convert<bool>::decode(node_, boolValue_);
+        }
+
+        template <typename T>
+        T as() const {
+            if constexpr (std::is_same_v<T, std::string>) {
+                if (isScalar_) return text_;
+            } else if constexpr (std::is_same_v<T, bool>) {
+                if (hasBool_) return boolValue_;
+            } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+                if (hasInt_ && intValue_ >= static_cast<long long>(std::numeric_limits<T>::min())
+                    && intValue_ <= static_cast<long long>(std::numeric_limits<T>::max())) {
+                    return static_cast<T>(intValue_);
+                }
+            } else if constexpr (std::is_integral_v<T>) {
+                if (hasUInt_ && uintValue_ <= static_cast<unsigned long long>(std::numeric_limits<T>::max())) {
+                    return static_cast<T>(uintValue_);
+                }
+            } else if constexpr (std::is_floating_point_v<T>) {
+                if (hasDouble_) return static_cast<T>(doubleValue_);
+            }
+            // 其他类型或转换失败：交给 yaml-cpp 转换（或抛出与原来相同的异常），yaml-cpp 节点不保证并发读安全
+            std::lock_guard<std::mutex> lock(fallbackMutex_);
+            return nodeLocked().template as<T>();
+        }
+
+        // 判断两个值是否相同：标量比较文本，按需拼出的映射逐个比较子值（共享的子值直接视为相同），
+        // 其他节点比较序列化结果
+        bool equals(const Value& other) const {
+            if (this == &other) return true;
+            if (isMap_ != other.isMap_) return false;
+            if (lazy_ && other.lazy_) {
+                if (children_.size() != other.children_.size()) return false;
+                for (size_t i = 0; i < children_.size(); ++i) {
+                    if (children_[i].first != other.children_[i].first) return false;
+                    if (!children_[i].second->equals(*other.children_[i].second)) return false;
+                }
+                return true;
+            }
+            if (!isMap_ && node_.Type() != other.node_.Type()) return false;
+            if (isScalar_) return text_ == other.text_;
+            std::scoped_lock lock(fallbackMutex_, other.fallbackMutex_);
+            return YAML::Dump(nodeLocked()) == YAML::Dump(other.nodeLocked());
+        }
+
+        bool isMap() const {
+            return isMap_;
+        }
+
+        // 是否为按需拼出的映射（键都是标量，children 即全部子项）
+        bool isLazy() const {
+            return lazy_;
+        }
+
+        const std::vector<Child>& children() const {
+            return children_;
+        }
+
+    private:
+        // 深拷贝节点，用于拼出父映射
+        YAML::Node clone() const {
+            std::lock_guard<std::mutex> lock(fallbackMutex_);
+            return YAML::Clone(nodeLocked());
+        }
+
+        // 返回节点，按需拼出的映射在第一次调用时由子值生成，需持有 fallbackMutex_
+        const YAML::Node& nodeLocked() const {
+            if (lazy_ && !materialized_) {
+                YAML::Node map(YAML::NodeType::Map);
+                for (const auto& child : children_) {
+                    map[unescapeSegment(child.first)] = child.second->clone();
+                }
+                node_ = map;
+                materialized_ = true;
+            }
+            return node_;
+        }
+
+        mutable YAML::Node node_;
+        std::vector<Child> children_;
+        bool isMap_ = false;
+        bool isScalar_ = false;
+        bool lazy_ = false;
+        mutable bool materialized_ = false;
+        std::string text_;
+        long long intValue_ = 0;
+        unsigned long long uintValue_ = 0;
+        double doubleValue_ = 0;
+        bool boolValue_ = false;
+        bool hasInt_ = false;
+        bool hasUInt_ = false;
+        bool hasDouble_ = false;
+        bool hasBool_ = false;
+        mutable std::mutex fallbackMutex_;
+    };
+
+    // 只读快照，发布后不再修改
+    // 扁平索引按键的哈希分为若干分片（约 4√N 个），分片以 shared_ptr 在快照之间共享，写入时只复制被修改的分片
+    struct Snapshot {
+        using Shard = std::unordered_map<std::string, std::shared_ptr<const Value>>;
+        std::vector<std::shared_ptr<const Shard>> shards{ std::make_shared<const Shard>() };
+        size_t size = 0;
+        uint64_t version = 0;
+
+        const Value* get(const std::string& key) const {
+            const Shard& shard = *shards[shardOf(key, shards.size())];
+            auto it = shard.find(key);
+            return it != shard.end() ? it->second.get() : nullptr;
+        }
+
+        static size_t shardOf(const std::string& key, size_t count) {
+            return std::hash<std::string>{}(key) & (count - 1);
+        }
+    };
+
+    // 以已发布的快照为基础构造新快照：分片先与原快照共享，第一次修改某个分片时才复制它
+    class SnapshotBuilder {
+    public:
+        SnapshotBuilder() : SnapshotBuilder(Snapshot()) {
+        }
+
+        explicit SnapshotBuilder(const Snapshot& base)
+            : snapshot_(std::make_shared<Snapshot>()), owned_(base.shards.size(), nullptr) {
+            snapshot_->shards = base.shards;
+            snapshot_->size = base.size;
+        }
+
+        const Value* get(const std::string& key) const {
+            return snapshot_->get(key);
+        }
+
+        void set(const std::string& key, std::shared_ptr<const Value> value) {
+            if (shard(key).insert_or_assign(key, std::move(value)).second) ++snapshot_->size;
+        }
+
+        void erase(const std::string& key) {
+            if (shard(key).erase(key) > 0) --snapshot_->size;
+        }
+
+        // 返回构造好的快照；分片数低于 2√N 时重新分片到约 4√N 个，分片数至少翻倍，均摊到每个键为常数
+        std::shared_ptr<Snapshot> finish() {
+            size_t count = snapshot_->shards.size();
+            if (snapshot_->size * 4 > count * count) {
+                size_t target = count;
+                while (target * target < snapshot_->size * 16) target <<= 1;
+                std::vector<std::shared_ptr<Snapshot::Shard>> shards(target);
+                for (auto& shard : shards) shard = std::make_shared<Snapshot::Shard>();
+                for (const auto& shard : snapshot_->shards) {
+                    for (const auto& item : *shard) {
+                        shards[Snapshot::shardOf(item.first, target)]->insert(item);
+                    }
+                }
+                snapshot_->shards.assign(shards.begin(), shards.end());
+            }
+            return std::move(snapshot_);
+        }
+
+    private:
+        Snapshot::Shard& shard(const std::string& key) {
+            size_t index = Snapshot::shardOf(key, owned_.size());
+            if (!owned_[index]) {
+                auto copy = std::make_shared<Snapshot::Shard>(*snapshot_->shards[index]);
+                owned_[index] = copy.get();
+                snapshot_->shards[index] = std::move(copy);
+            }
+            return *owned_[index];
+        }
+
+        std::shared_ptr<Snapshot> snapshot_;
+        std::vector<Snapshot::Shard*> owned_;  // 已复制、可修改的分片
+    };
+
+    static uint64_t nextInstanceId() {
+        static std::atomic<uint64_t> counter{ 0 };
+        return ++counter;
+    }
+
+    // 获取当前快照
+    // 每个线程缓存最近使用的快照，版本号未变化时只需一次原子读，不触及 shared_ptr 的引用计数
+    // 注：线程缓存会延长旧快照的生命周期，直到该线程下次读取
+    const Snapshot& currentSnapshot() const {
+        struct CacheEntry {
+            uint64_t owner = 0;
+            uint64_t version = 0;
+            std::shared_ptr<const Snapshot> snapshot;
+        };
+        thread_local std::array<CacheEntry, 4> cache;
+        thread_local size_t nextEntry = 0;
+
+        uint64_t version = version_.load(std::memory_order_acquire);
+        CacheEntry* entry = nullptr;
+        for (auto& candidate : cache) {
+            if (candidate.owner == id_) {
+                if (candidate.version == version) return *candidate.snapshot;
+                entry = &candidate;
+                break;
+            }
+        }
+        if (!entry) {
+            entry = &cache[nextEntry++ % cache.size()];
+        }
+        entry->snapshot = std::atomic_load(&snapshot_);
+        entry->owner = id_;
+        entry->version = entry->snapshot->version;
+        return *entry->snapshot;
+    }
+
+    // 发布新快照，需持有 mutex_
+    void publish(std::shared_ptr<Snapshot> snapshot) {
+        snapshot->version = ++publishedVersion_;
+        std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(std::move(snapshot)));
+        version_.store(publishedVersion_, std::memory_order_release);
+    }
+
+    // 查找键对应的值，不存在时返回 nullptr
+    // 未转义的含 '.' 的键先按嵌套路径查找，找不到时再按顶层同名键查找（兼容旧的配置文件）
+    static const Value* lookup(const Snapshot& snapshot, const std::string& key) {
+        if (const Value* value = snapshot.get(key)) return value;
+        if (key.find('.') == std::string::npos || key.find('\\') != std::string::npos) return nullptr;
+        return snapshot.get(escapeSegment(key));
+    }
+
+    static const Value& find(const Snapshot& snapshot, const std::string& key) {
+        const Value* value = lookup(snapshot, key);
+        if (!value) {
+            throw std::runtime_error("Key '" + key + "' not found in config file.");
+        }
+        return *value;
+    }
+
+    // 转义键名中的 '\' 与 '.'，得到索引中的路径段
+    static std::string escapeSegment(const std::string& name) {
+        if (name.find_first_of(".\\") == std::string::npos) return name;
+        std::string escaped;
+        escaped.reserve(name.size() + 4);
+        for (char c : name) {
+            if (c == '.' || c == '\\') escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    // 按未转义的 '.' 拆分路径并还原转义字符
+    static std::vector<std::string> splitPath(const std::string& key) {
+        std::vector<std::string> path(1);
+        for (size_t i = 0; i < key.size(); ++i) {
+            if (key[i] == '\\' && i + 1 < key.size()) {
+                path.back() += key[++i];
+            } else if (key[i] == '.') {
+                path.emplace_back();
+            } else {
+                path.back() += key[i];
+            }
+        }
+        return path;
+    }
+
+    // 还原 escapeSegment 转义的路径段
+    static std::string unescapeSegment(const std::string& segment) {
+        if (segment.find('\\') == std::string::npos) return segment;
+        std::string name;
+        name.reserve(segment.size());
+        for (size_t i = 0; i < segment.size(); ++i) {
+            if (segment[i] == '\\' && i + 1 < segment.size()) ++i;
+            name += segment[i];
+        }
+        return name;
+    }
+
+    // 把节点及其下所有嵌套映射以路径为键加入索引，返回节点对应的值
+    // 映射的键都是标量时按需拼出节点，否则整体深拷贝（仍索引其中的标量键）
+    static std::shared_ptr<const Value> indexNode(SnapshotBuilder& builder, const std::string& path, const YAML::Node& node) {
+        std::shared_ptr<const Value> value;
+        if (node.IsMap()) {
+            std::vector<Value::Child> children;
+            children.reserve(node.size());
+            bool scalarKeys = true;
+            for (const auto& item : node) {
+                if (!item.first.IsScalar()) {
+                    scalarKeys = false;
+                    continue;
+                }
+                std::string segment = escapeSegment(item.first.Scalar());
+                std::shared_ptr<const Value> child = indexNode(builder, path + "." + segment, item.second);
+                children.emplace_back(std::move(segment), std::move(child));
+            }
+            value = scalarKeys ? std::make_shared<const Value>(std::move(children))
+                               : std::make_shared<const Value>(YAML::Clone(node), std::move(children));
+        } else {
+            value = std::make_shared<const Value>(YAML::Clone(node));
+        }
+        builder.set(path, value);
+        return value;
+    }
+
+    // 从索引中删除 value 已索引的所有子项（不含 path 本身）
+    static void eraseChildren(SnapshotBuilder& builder, const std::string& path, const Value& value) {
+        for (const auto& child : value.children()) {
+            std::string childPath = path + "." + child.first;
+            eraseChildren(builder, childPath, *child.second);
+            builder.erase(childPath);
+        }
+    }
+
+    // 由配置树生成快照
+    static std::shared_ptr<Snapshot> buildSnapshot(const YAML::Node& root) {
+        SnapshotBuilder builder;
+        if (root.IsMap()) {
+            for (const auto& item : root) {
+                if (item.first.IsScalar()) {
+                    indexNode(builder, escapeSegment(item.first.Scalar()), item.second);
+                }
+            }
+        }
+        return builder.finish();
+    }
+
+    // 拆分写入路径，与 lookup 的规则一致：未转义的含 '.' 的键在嵌套路径不存在、
+    // 而顶层存在同名键时按原样写入该顶层键，兼容旧的配置文件
+    std::vector<std::string> splitForWrite(const std::string& key) const {
+        std::vector<std::string> path = splitPath(key);
+        if (path.size() > 1 && key.find('\\') == std::string::npos
+            && config_.IsMap() && config_[key] && !hasPath(path)) {
+            return { key };
+        }
+        return path;
+    }
+
+    // 配置树中是否存在 path 指向的节点，需持有 mutex_
+    bool hasPath(const std::vector<std::string>& path) const {
+        YAML::Node node = config_;
+        for (const auto& part : path) {
+            if (!node.IsMap()) return false;
+            YAML::Node child = static_cast<const YAML::Node&>(node)[part];
+            if (!child) return false;
+            node.reset(child);
+        }
+        return true;
+    }
+
+    // 写入 path 后更新快照中受影响的条目，需持有 mutex_
+    // 被写入节点：删除原有子树的索引后重新索引；各级父映射：复制子值列表并替换路径上的那一项
+    void reindex(SnapshotBuilder& builder, const std::vector<std::string>& path) const {
+        std::vector<YAML::Node> nodes;
+        std::vector<std::string> prefixes;
+        YAML::Node node = config_;
+        std::string prefix;
+        for (size_t i = 0; i < path.size(); ++i) {
+            node.reset(node[path[i]]);
+            prefix += (i == 0 ? "" : ".") + escapeSegment(path[i]);
+            nodes.push_back(node);
+            prefixes.push_back(prefix);
+        }
+
+        if (const Value* previous = builder.get(prefix)) {
+            eraseChildren(builder, prefix, *previous);
+        }
+        std::shared_ptr<const Value> child = indexNode(builder, prefix, node);
+
+        for (size_t i = path.size() - 1; i-- > 0;) {
+            const Value* previous = builder.get(prefixes[i]);
+            if (previous && !previous->isLazy()) {
+                // 原来不是映射（写入时被 yaml-cpp 转换为映射）或含非标量键：整体重新索引
+                eraseChildren(builder, prefixes[i], *previous);
+                child = indexNode(builder, prefixes[i], nodes[i]);
+                continue;
+            }
+            std::vector<Value::Child> children = previous ? previous->children() : std::vector<Value::Child>();
+            std::string segment = escapeSegment(path[i + 1]);
+            auto it = std::find_if(children.begin(), children.end(),
+                                   [&segment](const Value::Child& item) { return item.first == segment; });
+            if (it != children.end()) {
+                it->second = std::move(child);
+            } else {
+                children.emplace_back(std::move(segment), std::move(child));
+            }
+            child = std::make_shared<const Value>(std::move(children));
+            builder.set(prefixes[i], child);
+        }
+    }
+
+    struct Subscription {
+        size_t id;
+        std::string key;
+        ChangeCallback callback;
+    };
+
+    // 比较新旧快照中各订阅键的值，对发生变化的键调用回调
+    void notifySubscribers(const Snapshot& previous, const Snapshot& current) {
+        std::vector<std::shared_ptr<Subscription>> subscribers;
+        {
+            std::lock_guard<std::mutex> lock(subscribersMutex_);
+            subscribers = subscribers_;
+        }
+        for (const auto& subscription : subscribers) {
+            const Value* before = lookup(previous, subscription->key);
+            const Value* after = lookup(current, subscription->key);
+            if (!before == !after && (!before || before->equals(*after))) continue;
+            try {
+                subscription->callback(subscription->key);
+            } catch (const std::exception& e) {
+                std::cerr << "Error in config change callback for '" << subscription->key << "': " << e.what() << std::endl;
+            }
+        }
+    }
+
+    static std::string readFileContent(const std::string& filename) {
+        std::ifstream fin(filename, std::ios::binary);
+        if (!fin.is_open()) {
+            throw std::runtime_error("Error opening file for reading: " + filename);
+        }
+        std::ostringstream content;
+        content << fin.rdbuf();
+        return content.str();
+    }
+
     // 加载 YAML 配置文件
     void load() {
+        std::lock_guard<std::mutex> lock(mutex_);
         try {
-            config_ = YAML::LoadFile(filename_);
-        } catch (const YAML::Exception& e) {
+            fileContent_ = readFileContent(filename_);
+            config_ = YAML::Load(fileContent_);
+        } catch (const std::exception& e) {
             std::cerr << "Error loading YAML file: " << e.what() << std::endl;
             config_ = YAML::Node();
         }
+        publish(buildSnapshot(config_));
     }
 
-    // 保存当前配置到 YAML 文件
-    void save() {
-        std::ofstream fout(filename_);
-        if (!fout.is_open()) {
-            throw std::runtime_error("Error opening file for writing: " + filename_);
+    bool waitWatchStop(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(watchStopMutex_);
+        return watchCondition_.wait_for(lock, timeout, [this]() { return watchStopping_; });
+    }
+
+    // 轮询方式：文件修改时间或大小变化时重新加载
+    void pollLoop(std::chrono::milliseconds pollInterval) {
+        auto stamp = [this]() {
+            std::error_code ec;
+            auto time = std::filesystem::last_write_time(filename_, ec);
+            auto size = std::filesystem::file_size(filename_, ec);
+            return std::make_pair(time, ec ? std::uintmax_t(-1) : size);
+        };
+        auto last = stamp();
+        while (!waitWatchStop(pollInterval)) {
+            auto current = stamp();
+            if (current != last) {
+                last = current;
+                reload();
+            }
+        }
+    }
+
+    void watchLoop(std::chrono::milliseconds pollInterval) {
+#ifdef __linux__
+        int fd = inotify_init1(IN_CLOEXEC);
+        std::filesystem::path path(filename_);
+        std::string directory = path.has_parent_path() ? path.parent_path().string() : ".";
+        std::string name = path.filename().string();
+        if (fd >= 0 && wakeFd_ >= 0
+            && inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) >= 0) {
+            alignas(inotify_event) char buffer[4096];
+            pollfd fds[2] = { { fd, POLLIN, 0 }, { wakeFd_, POLLIN, 0 } };
+            while (true) {
+                if (::poll(fds, 2, -1) < 0) {
+                    if (errno == EINTR) continue;
+                    break;
+                }
+                if (fds[1].revents) break;
+                if (!(fds[0].revents & POLLIN)) continue;
+
+                ssize_t length = ::read(fd, buffer, sizeof(buffer));
+                bool changed = false;
+                for (ssize_t offset = 0; offset < length;) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    if (event->len > 0 && name == event->name) changed = true;
+                    offset += sizeof(inotify_event) + event->len;
+                }
+                if (changed) reload();
+            }
+            ::close(fd);
+            return;
+        }
+        if (fd >= 0) ::close(fd);
+#endif
+        pollLoop(pollInterval);
+    }
+
+    // 保存当前配置到 YAML 文件：在锁内序列化，在锁外写入临时文件后重命名为目标文件
+    // 调用时需持有 lock（mutex_），saveMutex_ 保证同一时间只有一个线程写文件
+    void saveLocked(std::unique_lock<std::mutex>& lock) {
+        lock.unlock();
+        std::lock_guard<std::mutex> saveLock(saveMutex_);
+        lock.lock();
+        if (!dirty_) return;
+
+        YAML::Emitter emitter;
+        emitter << config_;
+        std::string content = emitter.c_str();
+        dirty_ = false;
+        lock.unlock();
+
+        try {
+            std::string tempName = filename_ + ".tmp";
+            {
+                std::ofstream fout(tempName, std::ios::binary | std::ios::trunc);
+                if (!fout.is_open()) {
+                    throw std::runtime_error("Error opening file for writing: " + tempName);
+                }
+                fout << content;
+                fout.flush();
+                if (!fout) {
+                    throw std::runtime_error("Error writing file: " + tempName);
+                }
+            }
+            std::filesystem::rename(tempName, filename_);
+        } catch (...) {
+            lock.lock();
+            dirty_ = true;
+            throw;
+        }
+        lock.lock();
+        // 记录自身保存的内容，热加载时据此忽略本进程的保存
+        fileContent_ = std::move(content);
+    }
+
+    // 后台保存线程：写入停止 flushDelay_ 后保存，持续写入时最迟每 10 个 flushDelay_ 保存一次
+    void flushLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            flushCondition_.wait(lock, [this]() { return stopping_ || dirty_; });
+            if (!dirty_) return;
+
+            auto firstWrite = lastWrite_;
+            while (!stopping_ && dirty_) {
+                auto deadline = std::min(lastWrite_ + flushDelay_, firstWrite + flushDelay_ * 10);
+                if (std::chrono::steady_clock::now() >= deadline) break;
+                flushCondition_.wait_until(lock, deadline);
+            }
+
+            try {
+                saveLocked(lock);
+            } catch (const std::exception& e) {
+                std::cerr << "Error saving YAML file: " << e.what() << std::endl;
+                if (stopping_) return;
+                // 保存失败时等待一个延迟后重试
+                flushCondition_.wait_for(lock, flushDelay_, [this]() { return stopping_; });
+            }
         }
-        fout << config_;
     }
 
 private:
     std::string filename_;      // 配置文件路径
-    YAML::Node config_;         // 存储 YAML 配置内容
-    std::mutex mutex_;          // 用于同步文件访问
-};
\ No newline at end of file
+    YAML::Node config_;         // 存储 YAML 配置内容（写入使用，受 mutex_ 保护）
+    mutable std::mutex mutex_;  // 用于同步写入与文件访问
+    std::mutex saveMutex_;      // 保证同一时间只有一个线程写文件
+
+    std::shared_ptr<const Snapshot> snapshot_;  // 当前快照（原子读写）
+    std::atomic<uint64_t> version_{ 0 };        // 当前快照版本
+    uint64_t publishedVersion_ = 0;             // 最近发布的版本（受 mutex_ 保护）
+    const std::chrono::milliseconds flushDelay_;  // 延迟保存时间
+    const uint64_t id_;                         // 实例编号，区分线程缓存
+
+    bool dirty_ = false;                                    // 是否有未保存的修改
+    bool stopping_ = false;                                 // 是否正在析构
+    std::chrono::steady_clock::time_point lastWrite_;       // 最近一次写入时间
+    std::condition_variable flushCondition_;                // 唤醒后台保存线程
+    std::thread flusher_;                                   // 后台保存线程
+
+    std::string fileContent_;   // 当前配置对应的文件内容（受 mutex_ 保护），用于识别文件是否真正变化
+
+    std::mutex subscribersMutex_;                              // 保护订阅列表
+    std::vector<std::shared_ptr<Subscription>> subscribers_;   // 键变化订阅
+    size_t nextSubscriptionId_ = 0;                            // 最近分配的订阅编号
+
+    std::mutex watchMutex_;                    // 串行化热加载的开启与关闭
+    std::mutex watchStopMutex_;                // 保护 watchStopping_
+    std::condition_variable watchCondition_;   // 唤醒轮询方式的监视线程
+    bool watchStopping_ = false;               // 监视线程是否应退出
+    std::thread watcher_;                      // 文件监视线程
+#ifdef __linux__
+    int wakeFd_ = -1;                          // 唤醒 inotify 监视线程的 eventfd
+#endif
+};
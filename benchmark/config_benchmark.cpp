@@ -0,0 +1,159 @@
+// YAMLConfig 读取基准：测量多线程并发读取的 ns/op，以及同时存在写入时的读取开销；另测单次写入随配置规模的变化
+// 运行：./config_benchmark --benchmark_out=config.json --benchmark_out_format=json
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "YAMLConfig.h"
+
+static std::string configPath() {
+    static const std::string path = [] {
+        std::string file = (std::filesystem::temp_directory_path() / "headonly_bench_config.yaml").string();
+        std::ofstream out(file, std::ios::trunc);
+        out << "name: benchmark\n"
+               "server:\n"
+               "  host: localhost\n"
+               "  port: 8080\n"
+               "  pool:\n"
+               "    size: 16\n"
+               "    timeout: 2.5\n"
+               "features: [a, b, c]\n";
+        return file;
+    }();
+    return path;
+}
+
+// 所有线程共享同一个配置对象，由第一个线程创建，最后一个线程销毁
+static std::shared_ptr<YAMLConfig> sharedConfig;
+
+static void setupConfig(const benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        sharedConfig = std::make_shared<YAMLConfig>(configPath(), std::chrono::milliseconds(50));
+    }
+}
+
+static void teardownConfig(const benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        sharedConfig.reset();
+    }
+}
+
+static void BM_ReadTopLevelString(benchmark::State& state) {
+    setupConfig(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sharedConfig->read<std::string>("name"));
+    }
+    teardownConfig(state);
+}
+
+static void BM_ReadNestedInt(benchmark::State& state) {
+    setupConfig(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sharedConfig->read<int>("server.pool.size"));
+    }
+    teardownConfig(state);
+}
+
+static void BM_ReadSequence(benchmark::State& state) {
+    setupConfig(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sharedConfig->read<std::vector<std::string>>("features"));
+    }
+    teardownConfig(state);
+}
+
+static void BM_HandleDeref(benchmark::State& state) {
+    setupConfig(state);
+    // 屏障之后才能访问共享对象：benchmark 在计时循环开始前同步所有线程
+    std::unique_ptr<YAMLConfig::Handle<int>> handle;
+    for (auto _ : state) {
+        if (!handle) {
+            state.PauseTiming();
+            handle.reset(new YAMLConfig::Handle<int>(sharedConfig->handle<int>("server.pool.size")));
+            state.ResumeTiming();
+        }
+        benchmark::DoNotOptimize(handle->get());
+    }
+    handle.reset();
+    teardownConfig(state);
+}
+
+// 读取时另有一个线程每毫秒写入一次（每次写入都会发布新快照）
+static void BM_ReadNestedIntWithWriter(benchmark::State& state) {
+    setupConfig(state);
+    std::atomic<bool> stopWriter{ false };
+    std::thread writer;
+    bool first = true;
+    for (auto _ : state) {
+        if (first) {
+            first = false;
+            if (state.thread_index() == 0) {
+                state.PauseTiming();
+                writer = std::thread([&stopWriter]() {
+                    int value = 0;
+                    while (!stopWriter.load(std::memory_order_relaxed)) {
+                        sharedConfig->write("server.port", 8000 + (value++ % 1000));
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                });
+                state.ResumeTiming();
+            }
+        }
+        benchmark::DoNotOptimize(sharedConfig->read<int>("server.pool.size"));
+    }
+    if (writer.joinable()) {
+        stopWriter = true;
+        writer.join();
+    }
+    teardownConfig(state);
+}
+
+// 配置为每层 10 个键、共 depth 层的树（约 10^depth 个叶子）时，写入一个叶子的耗时（写入后延迟保存，计时期间不写文件）
+static void writeTree(std::ofstream& out, int level, int depth) {
+    for (int k = 0; k < 10; ++k) {
+        out << std::string(level * 2, ' ') << 'k' << k << ':';
+        if (level + 1 == depth) {
+            out << ' ' << k << '\n';
+        } else {
+            out << '\n';
+            writeTree(out, level + 1, depth);
+        }
+    }
+}
+
+static void BM_WriteLargeConfig(benchmark::State& state) {
+    const int depth = static_cast<int>(state.range(0));
+    std::string file = (std::filesystem::temp_directory_path() / "headonly_bench_config_large.yaml").string();
+    {
+        std::ofstream out(file, std::ios::trunc);
+        writeTree(out, 0, depth);
+    }
+    YAMLConfig config(file, std::chrono::hours(1));
+    int value = 0;
+    for (auto _ : state) {
+        std::string key;
+        for (int level = 0, rest = value; level < depth; ++level, rest /= 10) {
+            key += (level == 0 ? "k" : ".k") + std::to_string(rest % 10);
+        }
+        config.write(key, value);
+        ++value;
+    }
+    int64_t leaves = 1;
+    for (int level = 0; level < depth; ++level) leaves *= 10;
+    state.SetComplexityN(leaves);
+}
+
+BENCHMARK(BM_ReadTopLevelString)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_ReadNestedInt)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_ReadSequence)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_HandleDeref)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_ReadNestedIntWithWriter)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_WriteLargeConfig)->DenseRange(2, 5)->Complexity();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,101 @@
+// 编码转换基准：按文件大小分布测量 EncodingConverter 的吞吐量（MB/s）
+// 源文件为 GB18030（需要检测与转换）或 UTF-8（走快速跳过路径），转换会改写文件，因此每次迭代前重新生成
+// 运行：./convert_benchmark --benchmark_out=convert.json --benchmark_out_format=json
+
+#include <benchmark/benchmark.h>
+
+#include <unicode/ucnv.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "EncodingConverter.h"
+
+namespace fs = std::filesystem;
+
+// 生成指定大小的中英文混合文本（UTF-8），再按需转换为源编码
+static std::string sampleText(size_t size, const char* encoding) {
+    static const std::string line = u8"编码转换基准测试 encoding benchmark 行内容 0123456789\n";
+    std::string utf8;
+    utf8.reserve(size + line.size());
+    while (utf8.size() < size) utf8 += line;
+    if (std::string(encoding) == "UTF-8") return utf8;
+
+    UErrorCode status = U_ZERO_ERROR;
+    std::string output(utf8.size() * 2, '\0');
+    int32_t length = ucnv_convert(encoding, "UTF-8", &output[0], static_cast<int32_t>(output.size()),
+                                  utf8.data(), static_cast<int32_t>(utf8.size()), &status);
+    if (U_FAILURE(status)) return utf8;
+    output.resize(static_cast<size_t>(length));
+    return output;
+}
+
+// 测试目录：fileCount 个大小为 fileSize 的文件
+class Corpus {
+public:
+    Corpus(const std::string& name, size_t fileCount, size_t fileSize, const char* encoding)
+        : directory(fs::temp_directory_path() / ("headonly_bench_convert_" + name)),
+        content(sampleText(fileSize, encoding)), count(fileCount) {
+        fs::remove_all(directory);
+        fs::create_directories(directory);
+    }
+
+    ~Corpus() {
+        std::error_code ec;
+        fs::remove_all(directory, ec);
+    }
+
+    void generate() const {
+        for (size_t i = 0; i < count; ++i) {
+            std::ofstream out(directory / ("file_" + std::to_string(i) + ".txt"), std::ios::binary | std::ios::trunc);
+            out.write(content.data(), static_cast<std::streamsize>(content.size()));
+        }
+    }
+
+    size_t totalBytes() const {
+        return content.size() * count;
+    }
+
+    const fs::path directory;
+
+private:
+    const std::string content;
+    const size_t count;
+};
+
+// range(0) 为文件数，range(1) 为单个文件大小
+static void BM_Convert(benchmark::State& state, const char* encoding) {
+    const size_t fileCount = static_cast<size_t>(state.range(0));
+    const size_t fileSize = static_cast<size_t>(state.range(1));
+    Corpus corpus(std::string(encoding) + "_" + std::to_string(fileCount) + "x" + std::to_string(fileSize),
+                  fileCount, fileSize, encoding);
+
+    EncodingConverter converter;
+    converter.setLogLevel(EncodingConverter::LogLevel::ERROR);
+    for (auto _ : state) {
+        state.PauseTiming();
+        corpus.generate();
+        state.ResumeTiming();
+        converter.convert(corpus.directory.string(), "UTF-8");
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * corpus.totalBytes()));
+    state.counters["files"] = benchmark::Counter(static_cast<double>(state.iterations() * fileCount),
+                                                 benchmark::Counter::kIsRate);
+}
+
+// 文件大小分布：大量小文件、少量中等文件、单个大文件
+#define CONVERT_BENCHMARK(name, encoding) \
+    BENCHMARK_CAPTURE(BM_Convert, name, encoding) \
+        ->Args({ 2000, 4 << 10 }) \
+        ->Args({ 64, 256 << 10 }) \
+        ->Args({ 1, 16 << 20 }) \
+        ->UseRealTime()->Unit(benchmark::kMillisecond)
+
+CONVERT_BENCHMARK(GB18030, "GB18030");
+CONVERT_BENCHMARK(UTF8, "UTF-8");
+
+BENCHMARK_MAIN();
@@ -0,0 +1,55 @@
+// 哈希算法吞吐量基准：按算法与缓冲区大小测量 Hasher 的 GB/s
+// 运行：./hash_benchmark --benchmark_format=json 可输出 JSON 结果
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "Sign_Verify.h"
+
+// 生成固定的伪随机输入，避免全零数据带来的偏差
+static const std::vector<unsigned char>& benchmarkInput(size_t size) {
+    static std::vector<unsigned char> input;
+    if (input.size() < size) {
+        std::mt19937_64 random(42);
+        input.resize(size);
+        for (auto& byte : input) {
+            byte = static_cast<unsigned char>(random());
+        }
+    }
+    return input;
+}
+
+// 每次迭代对 bufferSize 大小的一块数据完整计算一次哈希（init/update/final）
+static void BM_Hash(benchmark::State& state, DigestAlgorithm algorithm) {
+    if (!isDigestAvailable(algorithm)) {
+        state.SkipWithError("digest algorithm not available");
+        return;
+    }
+
+    const size_t bufferSize = static_cast<size_t>(state.range(0));
+    const std::vector<unsigned char>& input = benchmarkInput(bufferSize);
+    Hasher hasher(algorithm);
+
+    for (auto _ : state) {
+        hasher.init();
+        hasher.update(input.data(), bufferSize);
+        std::vector<unsigned char> hash = hasher.final();
+        benchmark::DoNotOptimize(hash.data());
+    }
+
+    const double bytes = static_cast<double>(bufferSize) * static_cast<double>(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.counters["GB/s"] = benchmark::Counter(bytes / 1e9, benchmark::Counter::kIsRate);
+}
+
+#define HASH_BENCHMARK(algorithm) \
+    BENCHMARK_CAPTURE(BM_Hash, algorithm, DigestAlgorithm::algorithm)->RangeMultiplier(16)->Range(1 << 10, 16 << 20)
+
+HASH_BENCHMARK(SHA256);
+HASH_BENCHMARK(SHA512_256);
+HASH_BENCHMARK(BLAKE2b512);
+HASH_BENCHMARK(BLAKE3);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,203 @@
+// 签名与验证基准：按密钥类型测量 Signer / Verifier 每秒操作数
+// 密钥在启动时生成到临时目录，无需预先准备 PEM 文件
+// 运行：./sign_benchmark --benchmark_out=sign.json --benchmark_out_format=json
+
+#include <benchmark/benchmark.h>
+
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Sign_Verify.h"
+
+enum class KeyType { RSA2048, ECDSAP256, Ed25519 };
+
+// 生成密钥对并写入临时目录，返回私钥与公钥路径
+struct KeyFiles {
+    std::string privatePath;
+    std::string publicPath;
+};
+
+static const KeyFiles& keyFiles(KeyType type) {
+    static std::map<KeyType, KeyFiles> files;
+    auto it = files.find(type);
+    if (it != files.end()) return it->second;
+
+    EVP_PKEY* key = nullptr;
+    const char* name = "";
+    switch (type) {
+    case KeyType::RSA2048:
+        key = EVP_PKEY_Q_keygen(nullptr, nullptr, "RSA", static_cast<size_t>(2048));
+        name = "rsa2048";
+        break;
+    case KeyType::ECDSAP256:
+        key = EVP_PKEY_Q_keygen(nullptr, nullptr, "EC", "P-256");
+        name = "ecdsa_p256";
+        break;
+    case KeyType::Ed25519:
+        key = EVP_PKEY_Q_keygen(nullptr, nullptr, "ED25519");
+        name = "ed25519";
+        break;
+    }
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    KeyFiles result;
+    result.privatePath = (directory / (std::string("headonly_bench_") + name + ".pem")).string();
+    result.publicPath = (directory / (std::string("headonly_bench_") + name + ".pub")).string();
+    if (key) {
+        BIO* bio = BIO_new_file(result.privatePath.c_str(), "wb");
+        if (bio) {
+            PEM_write_bio_PrivateKey(bio, key, nullptr, nullptr, 0, nullptr, nullptr);
+            BIO_free(bio);
+        }
+        bio = BIO_new_file(result.publicPath.c_str(), "wb");
+        if (bio) {
+            PEM_write_bio_PUBKEY(bio, key);
+            BIO_free(bio);
+        }
+        EVP_PKEY_free(key);
+    }
+    return files.emplace(type, result).first->second;
+}
+
+// 旧的签名格式：对 SHA-256 哈希值签名（signHash / verifySignature 的实现）
+static void BM_SignHash(benchmark::State& state, KeyType type) {
+    CryptoStatus status;
+    Signer signer(keyFiles(type).privatePath, status);
+    if (!status) {
+        state.SkipWithError(status.toString().c_str());
+        return;
+    }
+    std::vector<unsigned char> hash = computeSHA256("benchmark message");
+    std::vector<unsigned char> signature;
+
+    for (auto _ : state) {
+        status = signer.sign(hash, signature);
+        benchmark::DoNotOptimize(signature.data());
+    }
+    if (!status) state.SkipWithError(status.toString().c_str());
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_VerifyHash(benchmark::State& state, KeyType type) {
+    CryptoStatus status;
+    Signer signer(keyFiles(type).privatePath, status);
+    Verifier verifier(keyFiles(type).publicPath, status);
+    if (!status) {
+        state.SkipWithError(status.toString().c_str());
+        return;
+    }
+    std::vector<unsigned char> hash = computeSHA256("benchmark message");
+    std::vector<unsigned char> signature;
+    signer.sign(hash, signature);
+
+    for (auto _ : state) {
+        status = verifier.check(hash, signature);
+        benchmark::DoNotOptimize(status);
+    }
+    if (!status) state.SkipWithError(status.toString().c_str());
+    state.SetItemsProcessed(state.iterations());
+}
+
+// 对已计算的 SHA-256 摘要直接签名（EVP_PKEY_sign），不再次哈希
+static void BM_SignDigest(benchmark::State& state, KeyType type) {
+    CryptoStatus status;
+    Signer signer(keyFiles(type).privatePath, status);
+    if (!status) {
+        state.SkipWithError(status.toString().c_str());
+        return;
+    }
+    std::vector<unsigned char> digest = computeSHA256("benchmark message");
+    std::vector<unsigned char> signature;
+
+    for (auto _ : state) {
+        status = signer.signDigest(digest, signature);
+        benchmark::DoNotOptimize(signature.data());
+    }
+    if (!status) state.SkipWithError(status.toString().c_str());
+    state.SetItemsProcessed(state.iterations());
+}
+
+// 一次遍历直接对数据签名（EVP_DigestSign），range(0) 为消息大小
+static void BM_SignData(benchmark::State& state, KeyType type) {
+    CryptoStatus status;
+    Signer signer(keyFiles(type).privatePath, status);
+    if (!status) {
+        state.SkipWithError(status.toString().c_str());
+        return;
+    }
+    std::vector<char> message(static_cast<size_t>(state.range(0)), 'x');
+    std::vector<unsigned char> signature;
+
+    for (auto _ : state) {
+        status = signer.signData(message.data(), message.size(), signature);
+        benchmark::DoNotOptimize(signature.data());
+    }
+    if (!status) state.SkipWithError(status.toString().c_str());
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_VerifyData(benchmark::State& state, KeyType type) {
+    CryptoStatus status;
+    Signer signer(keyFiles(type).privatePath, status);
+    Verifier verifier(keyFiles(type).publicPath, status);
+    if (!status) {
+        state.SkipWithError(status.toString().c_str());
+        return;
+    }
+    std::vector<char> message(static_cast<size_t>(state.range(0)), 'x');
+    std::vector<unsigned char> signature;
+    signer.signData(message.data(), message.size(), signature);
+
+    for (auto _ : state) {
+        status = verifier.verifyData(message.data(), message.size(), signature);
+        benchmark::DoNotOptimize(status);
+    }
+    if (!status) state.SkipWithError(status.toString().c_str());
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// 多线程共享同一个 Verifier（每个线程复用自己的摘要上下文）
+static void BM_VerifyHashShared(benchmark::State& state) {
+    static CryptoStatus status;
+    static Verifier verifier(keyFiles(KeyType::ECDSAP256).publicPath, status);
+    static std::vector<unsigned char> hash = computeSHA256("benchmark message");
+    static std::vector<unsigned char> signature = [] {
+        std::vector<unsigned char> result;
+        Signer(keyFiles(KeyType::ECDSAP256).privatePath).sign(hash, result);
+        return result;
+    }();
+
+    for (auto _ : state) {
+        CryptoStatus result = verifier.check(hash, signature);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// 对哈希值签名与摘要签名只适用于 RSA/ECDSA，Ed25519 只测直接对数据签名
+#define HASH_SIGN_BENCHMARKS(type) \
+    BENCHMARK_CAPTURE(BM_SignHash, type, KeyType::type); \
+    BENCHMARK_CAPTURE(BM_VerifyHash, type, KeyType::type); \
+    BENCHMARK_CAPTURE(BM_SignDigest, type, KeyType::type)
+
+#define DATA_SIGN_BENCHMARKS(type) \
+    BENCHMARK_CAPTURE(BM_SignData, type, KeyType::type)->Arg(1 << 10)->Arg(1 << 20); \
+    BENCHMARK_CAPTURE(BM_VerifyData, type, KeyType::type)->Arg(1 << 10)->Arg(1 << 20)
+
+HASH_SIGN_BENCHMARKS(RSA2048);
+HASH_SIGN_BENCHMARKS(ECDSAP256);
+DATA_SIGN_BENCHMARKS(RSA2048);
+DATA_SIGN_BENCHMARKS(ECDSAP256);
+DATA_SIGN_BENCHMARKS(Ed25519);
+BENCHMARK(BM_VerifyHashShared)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,95 @@
+// 定时器基准：测量 Timer 在不同等待方式与间隔下的触发延迟分位数，以及 TimerService 的添加/取消开销
+// 延迟计数器单位为微秒；每个用例只运行一次，由 Timer 自身的统计给出分位数
+// 运行：./timer_benchmark --benchmark_out=timer.json --benchmark_out_format=json
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "Timer.h"
+#include "TimerService.h"
+
+// 每个用例的触发次数
+static constexpr int64_t timerTicks = 2000;
+
+// range(0) 为间隔（微秒）
+static void BM_TimerLateness(benchmark::State& state, Timer::WaitMode mode) {
+    const int64_t intervalUs = state.range(0);
+    Timer::Statistics stats;
+    for (auto _ : state) {
+        Timer timer;
+        timer.setStatisticsEnabled(true);
+        timer.setWaitMode(mode);
+        std::atomic<int64_t> ticks{ 0 };
+        timer.startMicroseconds(intervalUs, [&ticks]() {
+            ticks.fetch_add(1, std::memory_order_relaxed);
+        });
+        while (ticks.load(std::memory_order_relaxed) < timerTicks) {
+            std::this_thread::sleep_for(std::chrono::microseconds(intervalUs * 16));
+        }
+        timer.stop();
+        stats = timer.statistics();
+    }
+
+    state.counters["ticks"] = static_cast<double>(stats.ticks);
+    state.counters["overruns"] = static_cast<double>(stats.overruns);
+    state.counters["lateness_p50_us"] = static_cast<double>(stats.latenessP50) / 1e3;
+    state.counters["lateness_p99_us"] = static_cast<double>(stats.latenessP99) / 1e3;
+    state.counters["lateness_max_us"] = static_cast<double>(stats.latenessMax) / 1e3;
+}
+
+BENCHMARK_CAPTURE(BM_TimerLateness, Sleep, Timer::WaitMode::Sleep)
+    ->Arg(100)->Arg(1000)->Iterations(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_TimerLateness, Precision, Timer::WaitMode::Precision)
+    ->Arg(100)->Arg(1000)->Iterations(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// 添加一次性定时器并立即取消，range(0) 为时间轮中已有的定时器数量
+static void BM_TimerServiceScheduleCancel(benchmark::State& state) {
+    TimerService service;
+    std::vector<TimerService::Handle> background;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        background.push_back(service.scheduleOnce(std::chrono::hours(1), []() {}));
+    }
+
+    for (auto _ : state) {
+        TimerService::Handle handle = service.scheduleOnce(std::chrono::seconds(10), []() {});
+        benchmark::DoNotOptimize(service.cancel(handle));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_TimerServiceScheduleCancel)->Arg(0)->Arg(10000);
+
+// TimerService 一次性定时器的触发延迟：每隔一段时间添加一个 1 毫秒后到期的定时器，记录实际执行时刻
+static void BM_TimerServiceLateness(benchmark::State& state) {
+    const int count = 500;
+    std::vector<int64_t> lateness(count);
+    for (auto _ : state) {
+        TimerService service;
+        std::atomic<int> fired{ 0 };
+        for (int i = 0; i < count; ++i) {
+            auto due = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+            service.scheduleOnce(std::chrono::milliseconds(1), [&lateness, &fired, due, i]() {
+                lateness[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - due).count();
+                fired.fetch_add(1, std::memory_order_release);
+            });
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        while (fired.load(std::memory_order_acquire) < count) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    std::sort(lateness.begin(), lateness.end());
+    state.counters["lateness_p50_us"] = static_cast<double>(lateness[count / 2]) / 1e3;
+    state.counters["lateness_p99_us"] = static_cast<double>(lateness[count * 99 / 100]) / 1e3;
+    state.counters["lateness_max_us"] = static_cast<double>(lateness.back()) / 1e3;
+}
+
+BENCHMARK(BM_TimerServiceLateness)->Iterations(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();